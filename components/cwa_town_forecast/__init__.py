@@ -1,7 +1,7 @@
 import esphome.codegen as cg
 import esphome.config_validation as cv
-from esphome.const import CONF_ID, CONF_TIME_ID
-from esphome.components import time, http_request
+from esphome.const import CONF_ID, CONF_TIME_ID, CONF_TYPE
+from esphome.components import time, http_request, web_server_base
 from esphome import automation
 
 DEPENDENCIES = ["network", "time", "http_request"]
@@ -14,8 +14,13 @@ CWATownForecast = cwa_town_forecast_ns.class_("CWATownForecast", cg.PollingCompo
 CWATownForecastRecord = cwa_town_forecast_ns.struct("Record")
 CWATownForecastRecordRef = CWATownForecastRecord.operator("ref")
 
+FileForecastSource = cwa_town_forecast_ns.class_("FileForecastSource")
+ReplayForecastSource = cwa_town_forecast_ns.class_("ReplayForecastSource")
+FeedForecastSource = cwa_town_forecast_ns.class_("FeedForecastSource")
+
 CWATownForecastMode = cwa_town_forecast_ns.enum("Mode")
 CWATownForecastEarlyDataClear = cwa_town_forecast_ns.enum("EarlyDataClear")
+CWATownForecastElementValueKey = cwa_town_forecast_ns.enum("ElementValueKey", is_class=True)
 
 MODE_THREE_DAYS = "3-DAYS"
 MODE_SEVEN_DAYS = "7-DAYS"
@@ -33,6 +38,37 @@ EarlyDataClear = {
     EARLY_DATA_CLEAR_OFF: CWATownForecastEarlyDataClear.OFF,
 }
 
+# lambda_keys entries, named like the sensors that publish them
+ElementValueKey = {
+    name: getattr(CWATownForecastElementValueKey, name.upper())
+    for name in [
+        "temperature",
+        "dew_point",
+        "apparent_temperature",
+        "comfort_index",
+        "comfort_index_description",
+        "relative_humidity",
+        "wind_direction",
+        "wind_speed",
+        "beaufort_scale",
+        "probability_of_precipitation",
+        "weather",
+        "weather_code",
+        "weather_description",
+        "weather_icon",
+        "max_temperature",
+        "min_temperature",
+        "max_apparent_temperature",
+        "min_apparent_temperature",
+        "max_comfort_index",
+        "max_comfort_index_description",
+        "min_comfort_index",
+        "min_comfort_index_description",
+        "uv_index",
+        "uv_exposure_level",
+    ]
+}
+
 CONF_CWA_TOWN_FORECAST_ID = "cwa_town_forecast_id"
 
 CONF_API_KEY = "api_key"
@@ -41,15 +77,45 @@ CONF_TOWN_NAME = "town_name"
 CONF_TIME_TO = "time_to"
 CONF_MODE = "mode"
 CONF_WEATHER_ELEMENTS = "weather_elements"
+CONF_AUTO_WEATHER_ELEMENTS = "auto_weather_elements"
+CONF_LAMBDA_KEYS = "lambda_keys"
 CONF_FALLBACK_TO_FIRST_ELEMENT = "fallback_to_first_element"
 CONF_SENSOR_EXPIRY = "sensor_expiry"
 CONF_RETAIN_FETCHED_DATA = "retain_fetched_data"
+CONF_RETAIN_CAPACITY = "retain_capacity"
+CONF_MEMORY_BUDGET = "memory_budget"
+CONF_REPUBLISH_ON_SLOT_CHANGE = "republish_on_slot_change"
+CONF_SKIP_UNCHANGED_STATES = "skip_unchanged_states"
 CONF_EARLY_DATA_CLEAR = "early_data_clear"
 CONF_ON_DATA_CHANGE = "on_data_change"
 CONF_ON_ERROR = "on_error"
+CONF_ON_UPDATE_COMPLETE = "on_update_complete"
+CONF_DEEP_SLEEP_STATE = "deep_sleep_state"
+
+CONF_SOURCE = "source"
+CONF_BASE_URL = "base_url"
+CONF_PATH = "path"
+CONF_PATHS = "paths"
+SOURCE_HTTP = "http"
+SOURCE_FILE = "file"
+SOURCE_REPLAY = "replay"
+SOURCE_FEED = "feed"
+CONF_URL = "url"
+CONF_FEED = "feed"
+CONF_WEB_SERVER_BASE_ID = "web_server_base_id"
+DEFAULT_FEED_PATH = "/cwa_town_forecast"
+
+CONF_PREFETCH = "prefetch"
+CONF_PERIOD = "period"
+CONF_OFFSET = "offset"
+CONF_DELAY = "delay"
+CONF_JITTER = "jitter"
+CONF_RECHECK = "recheck"
 
 CONF_RETRY_COUNT = "retry_count"
 CONF_RETRY_DELAY = "retry_delay"
+CONF_LARGE_STRING_POOL = "large_string_pool"
+CONF_ALLOC_TRACE = "alloc_trace"
 
 CHILD_SCHEMA = cv.Schema(
     {
@@ -114,6 +180,88 @@ WEATHER_ELEMENT_NAMES_7DAYS = [
 ]
 
 
+SOURCE_SCHEMA = cv.typed_schema(
+    {
+        SOURCE_HTTP: cv.Schema({}),
+        SOURCE_FILE: cv.Schema(
+            {
+                cv.GenerateID(): cv.declare_id(FileForecastSource),
+                cv.Required(CONF_PATH): cv.string,
+            }
+        ),
+        SOURCE_REPLAY: cv.Schema(
+            {
+                cv.GenerateID(): cv.declare_id(ReplayForecastSource),
+                cv.Required(CONF_PATHS): cv.All(cv.ensure_list(cv.string), cv.Length(min=1)),
+            }
+        ),
+        SOURCE_FEED: cv.Schema(
+            {
+                cv.GenerateID(): cv.declare_id(FeedForecastSource),
+                cv.Required(CONF_URL): cv.url,
+            }
+        ),
+    },
+    default_type=SOURCE_HTTP,
+    lower=True,
+)
+
+
+def validate_feed_path(value):
+    value = cv.string(value)
+    if not value.startswith("/"):
+        raise cv.Invalid("Feed path must start with '/'")
+    return value
+
+
+FEED_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(CONF_WEB_SERVER_BASE_ID): cv.use_id(web_server_base.WebServerBase),
+        cv.Optional(CONF_PATH, default=DEFAULT_FEED_PATH): validate_feed_path,
+    }
+)
+
+
+def validate_feed_paths(configs):
+    paths = [c[CONF_FEED][CONF_PATH] for c in configs if CONF_FEED in c]
+    for path in paths:
+        if paths.count(path) > 1:
+            raise cv.Invalid(f"Feed path '{path}' is used by more than one instance")
+    return configs
+
+
+def validate_prefetch(config):
+    period = config[CONF_PERIOD].total_seconds
+    if 86400 % period != 0:
+        raise cv.Invalid("Prefetch period must divide 24h evenly")
+    if config[CONF_OFFSET].total_seconds >= period:
+        raise cv.Invalid("Prefetch offset must be less than the period")
+    if config[CONF_DELAY].total_seconds > period // 2:
+        raise cv.Invalid("Prefetch delay must be at most half the period")
+    return config
+
+
+# Township forecasts are issued every 6 hours from 05:00 Taiwan time
+PREFETCH_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            cv.Optional(CONF_PERIOD, default="6h"): cv.All(
+                cv.positive_time_period_seconds,
+                cv.Range(min=cv.TimePeriod(hours=1), max=cv.TimePeriod(hours=24)),
+            ),
+            cv.Optional(CONF_OFFSET, default="5h"): cv.positive_time_period_seconds,
+            cv.Optional(CONF_DELAY, default="10min"): cv.positive_time_period_seconds,
+            cv.Optional(CONF_JITTER, default="5min"): cv.positive_time_period_seconds,
+            cv.Optional(CONF_RECHECK, default="10min"): cv.All(
+                cv.positive_time_period_seconds,
+                cv.Range(min=cv.TimePeriod(minutes=1)),
+            ),
+        }
+    ),
+    validate_prefetch,
+)
+
+
 def validate_mode_weather_elements(config):
     mode = config.get(CONF_MODE)
     if mode == MODE_THREE_DAYS:
@@ -144,9 +292,17 @@ CONFIG_SCHEMA = cv.All(
                 ),
                 cv.Optional(CONF_TOWN_NAME, default=""): cv.templatable(cv.string),
                 cv.Required(CONF_MODE): cv.enum(Mode, upper=True),
+                cv.Optional(CONF_SOURCE, default={}): SOURCE_SCHEMA,
+                cv.Optional(CONF_BASE_URL): cv.url,
+                cv.Optional(CONF_FEED): FEED_SCHEMA,
+                cv.Optional(CONF_PREFETCH): PREFETCH_SCHEMA,
                 cv.Optional(CONF_WEATHER_ELEMENTS, default=[]): cv.ensure_list(
                     cv.string
                 ),
+                cv.Optional(CONF_AUTO_WEATHER_ELEMENTS, default=True): cv.boolean,
+                cv.Optional(CONF_LAMBDA_KEYS, default=[]): cv.ensure_list(
+                    cv.enum(ElementValueKey, lower=True)
+                ),
                 cv.Optional(CONF_TIME_TO): cv.templatable(
                     cv.All(
                         cv.positive_not_null_time_period,
@@ -165,11 +321,21 @@ CONFIG_SCHEMA = cv.All(
                 cv.Optional(CONF_RETAIN_FETCHED_DATA, default=False): cv.templatable(
                     cv.boolean
                 ),
+                cv.Optional(CONF_RETAIN_CAPACITY): cv.templatable(cv.boolean),
+                cv.Optional(CONF_MEMORY_BUDGET): cv.int_range(min=1024),
+                cv.Optional(CONF_REPUBLISH_ON_SLOT_CHANGE): cv.templatable(cv.boolean),
+                cv.Optional(CONF_SKIP_UNCHANGED_STATES, default=False): cv.templatable(
+                    cv.boolean
+                ),
                 cv.Optional(
                     CONF_EARLY_DATA_CLEAR, default=EARLY_DATA_CLEAR_AUTO
                 ): cv.templatable(cv.enum(EarlyDataClear, upper=True)),
                 cv.Optional(CONF_ON_DATA_CHANGE): automation.validate_automation(),
                 cv.Optional(CONF_ON_ERROR): automation.validate_automation(),
+                cv.Optional(
+                    CONF_ON_UPDATE_COMPLETE
+                ): automation.validate_automation(),
+                cv.Optional(CONF_DEEP_SLEEP_STATE, default=False): cv.boolean,
                 cv.Optional(CONF_RETRY_COUNT, default=1): cv.templatable(
                     cv.All(cv.int_range(min=0, max=5))
                 ),
@@ -179,17 +345,22 @@ CONFIG_SCHEMA = cv.All(
                         cv.positive_time_period_milliseconds,
                     )
                 ),
+                cv.Optional(CONF_LARGE_STRING_POOL, default=False): cv.boolean,
+                cv.Optional(CONF_ALLOC_TRACE, default=False): cv.boolean,
             }
         )
         .add_extra(validate_mode_weather_elements)
         .extend(cv.polling_component_schema("never")),
     ),
+    validate_feed_paths,
     cv.only_on_esp32,
     cv.require_esphome_version(2026, 2, 0),
 )
 
 
 async def to_code(configs):
+    # Each instance keeping state across deep sleep gets its own RTC memory slot
+    sleep_state_slots = 0
     for config in configs:
         var = cg.new_Pvariable(config[CONF_ID])
         await cg.register_component(var, config)
@@ -200,6 +371,37 @@ async def to_code(configs):
         if CONF_HTTP_REQUEST_ID in config:
             http_req = await cg.get_variable(config[CONF_HTTP_REQUEST_ID])
             cg.add(var.set_http_request(http_req))
+        source_config = config[CONF_SOURCE]
+        if source_config[CONF_TYPE] == SOURCE_FILE:
+            source = cg.new_Pvariable(source_config[CONF_ID], source_config[CONF_PATH])
+            cg.add(var.set_source(source))
+        elif source_config[CONF_TYPE] == SOURCE_REPLAY:
+            source = cg.new_Pvariable(source_config[CONF_ID])
+            for path in source_config[CONF_PATHS]:
+                cg.add(source.add_path(path))
+            cg.add(var.set_source(source))
+        elif source_config[CONF_TYPE] == SOURCE_FEED:
+            source = cg.new_Pvariable(source_config[CONF_ID], source_config[CONF_URL])
+            if CONF_HTTP_REQUEST_ID in config:
+                cg.add(source.set_http_request(http_req))
+            cg.add(var.set_source(source))
+        if CONF_FEED in config:
+            cg.add_define("CWA_FEED_SERVER")
+            base = await cg.get_variable(config[CONF_FEED][CONF_WEB_SERVER_BASE_ID])
+            cg.add(var.set_feed_server(base, config[CONF_FEED][CONF_PATH]))
+        if CONF_PREFETCH in config:
+            prefetch = config[CONF_PREFETCH]
+            cg.add(
+                var.set_prefetch(
+                    prefetch[CONF_PERIOD].total_seconds,
+                    prefetch[CONF_OFFSET].total_seconds,
+                    prefetch[CONF_DELAY].total_seconds,
+                    prefetch[CONF_JITTER].total_seconds,
+                    prefetch[CONF_RECHECK].total_seconds,
+                )
+            )
+        if CONF_BASE_URL in config:
+            cg.add(var.set_base_url(config[CONF_BASE_URL]))
         if CONF_API_KEY in config:
             api_key = await cg.templatable(config[CONF_API_KEY], [], cg.std_string)
             cg.add(var.set_api_key(api_key))
@@ -213,6 +415,11 @@ async def to_code(configs):
             cg.add(var.set_mode(config[CONF_MODE]))
         for weather_element in config[CONF_WEATHER_ELEMENTS]:
             cg.add(var.add_weather_element(weather_element))
+        cg.add(var.set_auto_weather_elements(config[CONF_AUTO_WEATHER_ELEMENTS]))
+        for key in config[CONF_LAMBDA_KEYS]:
+            cg.add(var.add_required_key(key))
+        if config.get(CONF_ON_DATA_CHANGE):
+            cg.add(var.set_has_data_change_automation(True))
         if CONF_TIME_TO in config:
             time_to = await cg.templatable(config[CONF_TIME_TO], [], cg.uint32)
             cg.add(var.set_time_to(time_to))
@@ -231,6 +438,23 @@ async def to_code(configs):
                 config[CONF_RETAIN_FETCHED_DATA], [], cg.bool_
             )
             cg.add(var.set_retain_fetched_data(access))
+        if CONF_RETAIN_CAPACITY in config:
+            retain_capacity = await cg.templatable(
+                config[CONF_RETAIN_CAPACITY], [], cg.bool_
+            )
+            cg.add(var.set_retain_capacity(retain_capacity))
+        if CONF_MEMORY_BUDGET in config:
+            cg.add(var.set_memory_budget(config[CONF_MEMORY_BUDGET]))
+        if CONF_REPUBLISH_ON_SLOT_CHANGE in config:
+            republish = await cg.templatable(
+                config[CONF_REPUBLISH_ON_SLOT_CHANGE], [], cg.bool_
+            )
+            cg.add(var.set_republish_on_slot_change(republish))
+        if CONF_SKIP_UNCHANGED_STATES in config:
+            skip_unchanged = await cg.templatable(
+                config[CONF_SKIP_UNCHANGED_STATES], [], cg.bool_
+            )
+            cg.add(var.set_skip_unchanged_states(skip_unchanged))
         if CONF_EARLY_DATA_CLEAR in config:
             early_data_clear = await cg.templatable(
                 config[CONF_EARLY_DATA_CLEAR], [], CWATownForecastEarlyDataClear
@@ -248,11 +472,35 @@ async def to_code(configs):
                 [],
                 trigger,
             )
+        for trigger in config.get(CONF_ON_UPDATE_COMPLETE, []):
+            await automation.build_automation(
+                var.get_on_update_complete_trigger(),
+                [],
+                trigger,
+            )
+        if config[CONF_DEEP_SLEEP_STATE]:
+            cg.add(var.set_sleep_state_slot(sleep_state_slots))
+            sleep_state_slots += 1
         if CONF_RETRY_COUNT in config:
             retry_count = await cg.templatable(config[CONF_RETRY_COUNT], [], cg.uint32)
             cg.add(var.set_retry_count(retry_count))
         if CONF_RETRY_DELAY in config:
             retry_delay = await cg.templatable(config[CONF_RETRY_DELAY], [], cg.uint32)
             cg.add(var.set_retry_delay(retry_delay))
+        # Offset width is a storage layout choice, so it applies to every
+        # instance once any of them asks for it
+        if config[CONF_LARGE_STRING_POOL]:
+            cg.add_define("CWA_LARGE_STRING_POOL")
+        if config[CONF_ALLOC_TRACE]:
+            cg.add_define("CWA_ALLOC_TRACE")
+        # Only the parsers for configured modes are compiled in
+        if config[CONF_MODE] == MODE_THREE_DAYS:
+            cg.add_define("CWA_MODE_THREE_DAYS")
+        else:
+            cg.add_define("CWA_MODE_SEVEN_DAYS")
+
+    if sleep_state_slots > 0:
+        cg.add_define("CWA_SLEEP_STATE")
+        cg.add_define("CWA_SLEEP_STATE_COUNT", sleep_state_slots)
 
     cg.add_library("sunset", None)
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+#include <cstdint>
+
+#include "esphome/core/log.h"
+
+#ifdef USE_ESP32
+#include "esp_memory_utils.h"
+#endif
+
+namespace esphome {
+namespace cwa_town_forecast {
+
+// Call-site categories for allocation tracing. PsramAllocator<T> picks one
+// from AllocCategoryOf<T>; the ArduinoJson allocator reports JSON.
+enum class AllocCategory : uint8_t {
+  TIMES,        // WeatherElement::times vectors
+  ELEMENTS,     // Record::weather_elements
+  STRING_POOL,  // pool buffer and compaction scratch
+  JSON,         // ArduinoJson slot documents
+  OTHER,
+};
+
+static constexpr size_t ALLOC_CATEGORY_COUNT = static_cast<size_t>(AllocCategory::OTHER) + 1;
+
+template<class T> struct AllocCategoryOf {
+  static constexpr AllocCategory value = AllocCategory::OTHER;
+};
+
+#ifdef CWA_ALLOC_TRACE
+// Compile-time opt-in (alloc_trace option) allocation counters. Reset at the
+// start of each parse and dumped once it finishes; single-threaded like the
+// rest of the component.
+class AllocTrace {
+ public:
+  struct Counters {
+    uint32_t allocs;
+    uint32_t reallocs;
+    uint32_t frees;
+    size_t bytes;        // requested by allocs and reallocs
+    size_t psram_bytes;  // of which landed in PSRAM
+  };
+
+  static void on_alloc(AllocCategory category, const void *ptr, size_t bytes, bool realloc = false) {
+    if (ptr == nullptr)
+      return;
+    Counters &c = counters_()[static_cast<size_t>(category)];
+    if (realloc) {
+      ++c.reallocs;
+    } else {
+      ++c.allocs;
+    }
+    c.bytes += bytes;
+#ifdef USE_ESP32
+    if (esp_ptr_external_ram(ptr))
+      c.psram_bytes += bytes;
+#endif
+  }
+
+  static void on_free(AllocCategory category, const void *ptr) {
+    if (ptr != nullptr)
+      ++counters_()[static_cast<size_t>(category)].frees;
+  }
+
+  static void reset() {
+    for (size_t i = 0; i < ALLOC_CATEGORY_COUNT; ++i)
+      counters_()[i] = Counters{};
+  }
+
+  static void dump(const char *label) {
+    static constexpr const char *const NAMES[ALLOC_CATEGORY_COUNT] = {"times", "elements", "string_pool", "json",
+                                                                      "other"};
+    ESP_LOGI("cwa_town_forecast", "Allocation trace (%s):", label);
+    for (size_t i = 0; i < ALLOC_CATEGORY_COUNT; ++i) {
+      const Counters &c = counters_()[i];
+      ESP_LOGI("cwa_town_forecast",
+               "  %-11s allocs: %" PRIu32 ", reallocs: %" PRIu32 ", frees: %" PRIu32 ", bytes: %zu (PSRAM: %zu)",
+               NAMES[i], c.allocs, c.reallocs, c.frees, c.bytes, c.psram_bytes);
+    }
+  }
+
+ private:
+  static Counters *counters_() {
+    static Counters counters[ALLOC_CATEGORY_COUNT]{};
+    return counters;
+  }
+};
+#endif
+
+}  // namespace cwa_town_forecast
+}  // namespace esphome
@@ -17,6 +17,8 @@
 #include <ctime>
 #include <functional>
 
+#include <esp_attr.h>
+
 #include "esphome/components/network/util.h"
 #include "esphome/components/text_sensor/text_sensor.h"
 #include "esphome/core/helpers.h"
@@ -25,6 +27,11 @@
 namespace esphome {
 namespace cwa_town_forecast {
 
+#ifdef CWA_SLEEP_STATE
+// RTC slow memory, kept across deep sleep; one per instance with deep_sleep_state
+static RTC_DATA_ATTR SleepState sleep_states[CWA_SLEEP_STATE_COUNT];
+#endif
+
 bool Record::is_daytime(const std::tm &t) const {
   SunSet sun;
   sun.setPosition(this->latitude, this->longitude, this->timezone_offset);
@@ -51,6 +58,285 @@ WeatherIconInfo Record::find_weather_icon(bool fallback_to_first_element, const
   return info;
 }
 
+size_t WeatherElement::resample(ElementValueKey key, const std::tm &start, uint32_t step_seconds, float *out,
+                                size_t count, ResampleMethod method) const {
+  std::fill(out, out + count, NAN);
+  if (this->times.empty() || step_seconds == 0)
+    return 0;
+
+  const std::time_t start_epoch = TimeField::to_wall_epoch(start);
+  const size_t n = this->times.size();
+  const bool points = this->times[0].data_time.is_valid();
+  // Anchor of slot j: the DataTime point, or the interval midpoint
+  auto anchor = [&](size_t j) -> std::time_t {
+    const Time &t = this->times[j];
+    if (t.data_time)
+      return t.data_time.epoch();
+    return t.start_time_data.epoch() + (t.end_time_data.epoch() - t.start_time_data.epoch()) / 2;
+  };
+  auto value = [&](size_t j) -> float {
+    float v;
+    return this->find_numeric_value(this->times[j], key, v) ? v : NAN;
+  };
+
+  size_t valid = 0;
+  size_t j = 0;  // grid points only move forward, so the cursor does too
+  for (size_t i = 0; i < count; ++i) {
+    const std::time_t x = start_epoch + static_cast<std::time_t>(i) * step_seconds;
+    float v = NAN;
+    if (method == ResampleMethod::LINEAR) {
+      while (j + 1 < n && anchor(j + 1) <= x)
+        ++j;
+      const std::time_t a0 = anchor(j);
+      if (x == a0) {
+        v = value(j);
+      } else if (x > a0 && j + 1 < n) {
+        const std::time_t a1 = anchor(j + 1);
+        const float frac = static_cast<float>(x - a0) / static_cast<float>(a1 - a0);
+        v = value(j) + (value(j + 1) - value(j)) * frac;
+      }
+    } else if (points) {
+      while (j + 1 < n && this->times[j + 1].data_time.epoch() <= x)
+        ++j;
+      const std::time_t p0 = this->times[j].data_time.epoch();
+      // Past the last point, hold it for one more point spacing
+      const std::time_t next = j + 1 < n ? this->times[j + 1].data_time.epoch()
+                                         : (n > 1 ? p0 + (p0 - this->times[n - 2].data_time.epoch()) : p0 + 1);
+      if (x >= p0 && x < next)
+        v = value(j);
+    } else {
+      while (j < n && this->times[j].end_time_data.epoch() <= x)
+        ++j;
+      if (j < n && this->times[j].start_time_data.epoch() <= x)
+        v = value(j);
+    }
+    out[i] = v;
+    if (!std::isnan(v))
+      ++valid;
+  }
+  return valid;
+}
+
+void Record::update_time_bounds() {
+  bool first_time = true;
+  std::time_t min_epoch = 0;
+  std::time_t max_epoch = 0;
+  for (const auto &we : this->weather_elements) {
+    for (const auto &t : we.times) {
+      const TimeField &primary = t.primary_field();
+      if (!primary.is_valid()) {
+        continue;
+      }
+      std::time_t cand_epoch = primary.epoch();
+      if (first_time || cand_epoch < min_epoch) {
+        min_epoch = cand_epoch;
+      }
+      std::time_t end_cand = t.end_time_data.is_valid() ? t.end_time_data.epoch() : cand_epoch;
+      if (first_time || end_cand > max_epoch) {
+        max_epoch = end_cand;
+      }
+      first_time = false;
+    }
+  }
+  if (!first_time) {
+    this->start_time = TimeField(min_epoch).to_tm();
+    this->end_time = TimeField(max_epoch).to_tm();
+  }
+}
+
+void Record::build_daily_summaries() {
+  memset(this->daily_summary_valid, 0, sizeof(this->daily_summary_valid));
+  std::tm base = this->start_time;
+  base.tm_hour = 0;
+  base.tm_min = 0;
+  base.tm_sec = 0;
+  this->summary_base_epoch = TimeField::to_wall_epoch(base);
+  if (!this->string_pool)
+    return;
+
+  // Sums accumulate in mean until the final division
+  uint16_t counts[MAX_SUMMARY_DAYS][NUMERIC_ELEMENT_VALUE_KEY_COUNT] = {};
+  auto day_of = [this](std::time_t epoch) -> int {
+    std::time_t diff = epoch - this->summary_base_epoch;
+    return static_cast<int>(diff >= 0 ? diff / 86400 : (diff - 86399) / 86400);
+  };
+  for (const auto &we : this->weather_elements) {
+    for (const auto &t : we.times) {
+      int first_day, last_day;
+      if (t.data_time) {
+        first_day = last_day = day_of(t.data_time.epoch());
+      } else if (t.start_time_data.is_valid() && t.end_time_data.is_valid()) {
+        first_day = day_of(t.start_time_data.epoch());
+        last_day = day_of(t.end_time_data.epoch() - 1);
+      } else {
+        continue;
+      }
+      first_day = std::max(first_day, 0);
+      last_day = std::min(last_day, static_cast<int>(MAX_SUMMARY_DAYS) - 1);
+
+      for (const auto &v : t.element_values) {
+        const int8_t k = numeric_key_index(static_cast<ElementValueKey>(v.key));
+        if (k < 0)
+          continue;
+        const char *str = this->string_pool->get(v.offset);
+        char *endptr = nullptr;
+        float num = std::strtof(str, &endptr);
+        if (endptr == str || *endptr != '\0')
+          continue;
+        for (int d = first_day; d <= last_day; ++d) {
+          DailySummary &s = this->daily_summaries[d][k];
+          if (counts[d][k] == 0) {
+            s.min = s.max = s.mean = num;
+          } else {
+            s.min = std::min(s.min, num);
+            s.max = std::max(s.max, num);
+            s.mean += num;
+          }
+          ++counts[d][k];
+        }
+      }
+    }
+  }
+
+  for (size_t d = 0; d < MAX_SUMMARY_DAYS; ++d) {
+    for (size_t k = 0; k < NUMERIC_ELEMENT_VALUE_KEY_COUNT; ++k) {
+      if (counts[d][k] == 0)
+        continue;
+      this->daily_summaries[d][k].mean /= counts[d][k];
+      this->daily_summary_valid[d] |= 1u << k;
+    }
+  }
+}
+
+std::time_t Record::next_slot_boundary(std::time_t after_epoch) const {
+  std::time_t next = 0;
+  auto consider = [&](const TimeField &field) {
+    if (!field.is_valid())
+      return;
+    std::time_t epoch = field.epoch();
+    if (epoch > after_epoch && (next == 0 || epoch < next))
+      next = epoch;
+  };
+  for (const auto &we : this->weather_elements) {
+    for (const auto &t : we.times) {
+      consider(t.data_time);
+      consider(t.start_time_data);
+      consider(t.end_time_data);
+    }
+  }
+  return next;
+}
+
+size_t Record::prune_before(const std::tm &cutoff) {
+  std::time_t cutoff_epoch = TimeField::to_wall_epoch(cutoff);
+  size_t removed = 0;
+  for (auto &we : this->weather_elements) {
+    // DataTime series: the latest point at or before cutoff is still the
+    // current value (see match_time()), so only points before it go
+    size_t keep_from = 0;
+    for (size_t i = 0; i < we.times.size(); ++i) {
+      const Time &t = we.times[i];
+      if (t.data_time) {
+        if (t.data_time.epoch() <= cutoff_epoch)
+          keep_from = i;
+      } else if (t.end_time_data.is_valid() && t.end_time_data.epoch() <= cutoff_epoch) {
+        keep_from = i + 1;
+      }
+    }
+    if (keep_from > 0) {
+      we.times.erase(we.times.begin(), we.times.begin() + keep_from);
+      we.reset_cursor();
+      removed += keep_from;
+    }
+  }
+  if (removed > 0) {
+    ++this->generation;
+    this->update_time_bounds();
+    this->build_daily_summaries();
+    this->compact_string_pool();
+  }
+  return removed;
+}
+
+void Record::compact_string_pool() {
+  if (!this->string_pool)
+    return;
+  size_t before = this->string_pool->size();
+  auto compacted = std::make_shared<StringPool>(
+      this->string_pool->compacted([this](auto fn) { this->for_each_value_offset(fn); }));
+  for (auto &we : this->weather_elements)
+    we.string_pool = compacted;
+  this->string_pool = std::move(compacted);
+  ESP_LOGD(TAG, "String pool compacted: %zu -> %zu bytes", before, this->string_pool->size());
+}
+
+void Record::encode_feed(FeedBuffer &out, uint64_t hash_code) const {
+  static const char EMPTY_POOL[1] = {'\0'};
+  const char *pool_data = this->string_pool ? this->string_pool->data() : EMPTY_POOL;
+  const size_t pool_size = this->string_pool ? this->string_pool->size() : sizeof(EMPTY_POOL);
+  const uint8_t offset_bytes = pool_size > UINT16_MAX ? 4 : 2;
+  const size_t element_count = std::min<size_t>(this->weather_elements.size(), UINT8_MAX);
+  auto time_fields = [](const Time &t) -> uint8_t {
+    return (t.data_time.is_valid() ? FEED_DATA_TIME : 0) | (t.start_time_data.is_valid() ? FEED_START_TIME : 0) |
+           (t.end_time_data.is_valid() ? FEED_END_TIME : 0);
+  };
+
+  // Sized up front so the buffer is allocated once
+  size_t size = sizeof(FEED_MAGIC) + 4 + 8 + 8 + 8 + 8 + FeedWriter::str_size(this->locations_name) +
+                FeedWriter::str_size(this->location_name) + 4 + pool_size;
+  for (size_t e = 0; e < element_count; ++e) {
+    const WeatherElement &we = this->weather_elements[e];
+    const size_t slot_count = std::min<size_t>(we.times.size(), UINT16_MAX);
+    size += 3;
+    for (size_t i = 0; i < slot_count; ++i) {
+      const Time &t = we.times[i];
+      size += 1 + 4 * __builtin_popcount(time_fields(t)) + t.element_values.size() * (1 + offset_bytes);
+    }
+  }
+  out.clear();
+  out.reserve(size);
+
+  FeedWriter w(out);
+  w.bytes(FEED_MAGIC, sizeof(FEED_MAGIC));
+  w.u8(FEED_VERSION);
+  w.u8(static_cast<uint8_t>(this->mode));
+  w.u8(offset_bytes);
+  w.u8(static_cast<uint8_t>(element_count));
+  w.u64(hash_code);
+  w.u64(static_cast<uint64_t>(static_cast<int64_t>(TimeField::to_wall_epoch(this->updated_time))));
+  w.f64(this->latitude);
+  w.f64(this->longitude);
+  w.str(this->locations_name);
+  w.str(this->location_name);
+  w.u32(static_cast<uint32_t>(pool_size));
+  w.bytes(pool_data, pool_size);
+  for (size_t e = 0; e < element_count; ++e) {
+    const WeatherElement &we = this->weather_elements[e];
+    const size_t slot_count = std::min<size_t>(we.times.size(), UINT16_MAX);
+    w.u8(static_cast<uint8_t>(we.id));
+    w.u16(static_cast<uint16_t>(slot_count));
+    for (size_t i = 0; i < slot_count; ++i) {
+      const Time &t = we.times[i];
+      const uint8_t fields = time_fields(t);
+      w.u8(fields | static_cast<uint8_t>(t.element_values.size() << 4));
+      if (fields & FEED_DATA_TIME)
+        w.u32(static_cast<uint32_t>(t.data_time.epoch() - FEED_EPOCH_BASE));
+      if (fields & FEED_START_TIME)
+        w.u32(static_cast<uint32_t>(t.start_time_data.epoch() - FEED_EPOCH_BASE));
+      if (fields & FEED_END_TIME)
+        w.u32(static_cast<uint32_t>(t.end_time_data.epoch() - FEED_EPOCH_BASE));
+      for (const auto &v : t.element_values) {
+        w.u8(v.key);
+        if (offset_bytes == 2) {
+          w.u16(static_cast<uint16_t>(v.offset));
+        } else {
+          w.u32(static_cast<uint32_t>(v.offset));
+        }
+      }
+    }
+  }
+}
+
 // Returns the setup priority for the component.
 float CWATownForecast::get_setup_priority() const { return setup_priority::LATE; }
 
@@ -59,16 +345,31 @@ void CWATownForecast::setup() {
   if (CWA_PSRAM_AVAILABLE()) {
     ESP_LOGI(TAG, "PSRAM detected (%zu bytes), using extended memory allocation",
              heap_caps_get_total_size(MALLOC_CAP_SPIRAM));
-    this->record_.weather_elements.reserve(32);
+    for (auto &record : this->records_)
+      record.weather_elements.reserve(32);
     ESP_LOGV(TAG, "Using extended buffers for PSRAM");
   } else {
     ESP_LOGI(TAG, "No PSRAM detected, using conservative memory allocation");
-    this->record_.weather_elements.reserve(16);
+    this->record_().weather_elements.reserve(16);
 
     if (this->early_data_clear_.value() == EarlyDataClear::AUTO) {
       ESP_LOGV(TAG, "Auto-enabled early data clear for memory conservation");
     }
   }
+#ifdef CWA_FEED_SERVER
+  if (this->feed_base_ != nullptr) {
+    this->feed_base_->init();
+    this->feed_base_->add_handler(&this->feed_handler_);
+  }
+#endif
+#ifdef CWA_SLEEP_STATE
+  if (this->sleep_state_ != nullptr) {
+    this->restore_sleep_state_();
+  }
+#endif
+  if (this->prefetch_) {
+    this->start_prefetch_();
+  }
 }
 
 // Periodically called to update forecast data.
@@ -85,19 +386,54 @@ void CWATownForecast::update() {
     ESP_LOGD(TAG, "Cancelled pending retry, starting fresh request");
   }
 
+#ifdef CWA_SLEEP_STATE
+  if (this->sleep_state_ != nullptr && !this->fetch_needed_()) {
+    ESP_LOGD(TAG, "Snapshot still current, skipping fetch");
+    this->publish_snapshot_();
+    if (this->prefetch_) {
+      // Awake devices check again when the snapshot ends or an issue is due
+      time_t now = this->rtc_->now().timestamp;
+      time_t next = std::min<time_t>(this->sleep_state_->valid_until, this->schedule_.next_due());
+      this->set_timeout("cwa_prefetch", static_cast<uint32_t>(std::max<time_t>(next - now, 1)) * 1000,
+                        [this]() { this->update(); });
+    }
+    this->on_update_complete_trigger_.trigger();
+    return;
+  }
+#endif
   this->try_send_request_(0);
 }
 
 // Logs the component configuration.
 void CWATownForecast::dump_config() {
   ESP_LOGCONFIG(TAG, "CWA Town Forecast:");
-  ESP_LOGCONFIG(TAG, "  API Key: %s", api_key_.value().empty() ? "not set" : "set");
+  if (this->get_source()->needs_api_key()) {
+    ESP_LOGCONFIG(TAG, "  API Key: %s", api_key_.value().empty() ? "not set" : "set");
+  }
   ESP_LOGCONFIG(TAG, "  City Name: %s", city_name_.value().c_str());
   ESP_LOGCONFIG(TAG, "  Town Name: %s", town_name_.value().c_str());
   ESP_LOGCONFIG(TAG, "  Mode: %s", mode_to_string(mode_).c_str());
-  ESP_LOGCONFIG(TAG, "  Weather Elements: %s", this->weather_elements_.empty() ? "not set" : "");
-  for (const auto &element_name : this->weather_elements_) {
-    ESP_LOGCONFIG(TAG, "    %s", element_name.c_str());
+  ESP_LOGCONFIG(TAG, "  Source: %s", this->get_source()->name());
+  if (this->base_url_ != DEFAULT_BASE_URL) {
+    ESP_LOGCONFIG(TAG, "  Base URL: %s", this->base_url_.c_str());
+  }
+#ifdef CWA_FEED_SERVER
+  if (this->feed_base_ != nullptr) {
+    ESP_LOGCONFIG(TAG, "  Feed Path: %s", this->feed_handler_.get_path().c_str());
+  }
+#endif
+  if (!this->weather_elements_.empty()) {
+    ESP_LOGCONFIG(TAG, "  Weather Elements:");
+    for (const auto &element_name : this->weather_elements_) {
+      ESP_LOGCONFIG(TAG, "    %s", element_name.c_str());
+    }
+  } else if (this->derives_request_scope_()) {
+    ESP_LOGCONFIG(TAG, "  Weather Elements: auto");
+    for (const char *element_name : this->derive_weather_elements_()) {
+      ESP_LOGCONFIG(TAG, "    %s", element_name);
+    }
+  } else {
+    ESP_LOGCONFIG(TAG, "  Weather Elements: not set");
   }
   if (!time_to_.has_value()) {
     ESP_LOGCONFIG(TAG, "  Time To: not set");
@@ -107,17 +443,40 @@ void CWATownForecast::dump_config() {
   ESP_LOGCONFIG(TAG, "  Early Data Clear: %s", early_data_clear_to_string(early_data_clear_.value()).c_str());
   ESP_LOGCONFIG(TAG, "  Fallback to First Element: %s", fallback_to_first_element_.value() ? "true" : "false");
   ESP_LOGCONFIG(TAG, "  Retain Fetched Data: %s", retain_fetched_data_.value() ? "true" : "false");
+  ESP_LOGCONFIG(TAG, "  Retain Capacity: %s", this->retains_capacity_() ? "true" : "false");
+  if (this->memory_budget_ > 0) {
+    ESP_LOGCONFIG(TAG, "  Memory Budget: %" PRIu32 " bytes", this->memory_budget_);
+  }
+  ESP_LOGCONFIG(TAG, "  Republish on Slot Change: %s", this->republishes_on_slot_change_() ? "true" : "false");
+  if (this->republishes_on_slot_change_() && !retain_fetched_data_.value()) {
+    ESP_LOGW(TAG, "republish_on_slot_change has no effect without retain_fetched_data");
+  }
+  ESP_LOGCONFIG(TAG, "  Skip Unchanged States: %s", skip_unchanged_states_.value() ? "true" : "false");
   ESP_LOGCONFIG(TAG, "  Sensor Expiry: %" PRIu32 " minutes", sensor_expiry_.value() / 1000 / 60);
+  if (this->prefetch_) {
+    const PublicationSchedule &schedule = this->schedule_;
+    ESP_LOGCONFIG(TAG,
+                  "  Prefetch: every %" PRIu32 " min from %02" PRIu32 ":%02" PRIu32 " (UTC+8), delay %" PRIu32
+                  " s, jitter %" PRIu32 " s, recheck %" PRIu32 " s",
+                  schedule.get_period() / 60, schedule.get_offset() / 3600, schedule.get_offset() / 60 % 60,
+                  schedule.get_delay(), schedule.get_jitter(), schedule.get_recheck());
+  }
+#ifdef CWA_SLEEP_STATE
+  if (this->sleep_state_ != nullptr) {
+    ESP_LOGCONFIG(TAG, "  Deep Sleep State: %zu bytes of RTC memory", sizeof(SleepState));
+  }
+#endif
   ESP_LOGCONFIG(TAG, "  Retry Count: %" PRIu32, retry_count_.value());
   ESP_LOGCONFIG(TAG, "  Retry Delay: %" PRIu32 " ms", retry_delay_.value());
   ESP_LOGCONFIG(TAG, "  PSRAM Available: %s", CWA_PSRAM_AVAILABLE() ? "true" : "false");
+  ESP_LOGCONFIG(TAG, "  String Pool Offsets: %zu-bit", sizeof(StringPoolOffset) * 8);
   LOG_UPDATE_INTERVAL(this);
 }
 
 // Validates the configuration parameters.
 bool CWATownForecast::validate_config_() {
   bool valid = true;
-  if (api_key_.value().empty()) {
+  if (this->get_source()->needs_api_key() && api_key_.value().empty()) {
     ESP_LOGE(TAG, "API Key not set");
     valid = false;
   }
@@ -171,6 +530,67 @@ bool CWATownForecast::validate_config_() {
   return valid;
 }
 
+// Automatic ElementName/timeTo selection applies when weather_elements is not
+// set and every reader of the data is known: the configured sensors plus the
+// keys declared through lambda_keys. Retained data or on_data_change without
+// lambda_keys may be read by arbitrary lambdas, so the full response is kept.
+bool CWATownForecast::derives_request_scope_() {
+  if (!this->auto_weather_elements_ || !this->weather_elements_.empty())
+    return false;
+#ifdef CWA_FEED_SERVER
+  // Feed clients read whatever their own sensors need
+  if (this->feed_base_ != nullptr)
+    return false;
+#endif
+  if (!this->required_keys_.empty())
+    return true;
+  return !this->retain_fetched_data_.value() && !this->has_data_change_automation_;
+}
+
+// Elements holding the keys of configured sensors and declared lambda keys,
+// in MODE_ELEMENT_MAPPINGS naming.
+std::vector<const char *> CWATownForecast::derive_weather_elements_() {
+  const std::pair<bool, ElementValueKey> consumers[] = {
+      {this->temperature_ != nullptr, ElementValueKey::TEMPERATURE},
+      {this->dew_point_ != nullptr, ElementValueKey::DEW_POINT},
+      {this->apparent_temperature_ != nullptr, ElementValueKey::APPARENT_TEMPERATURE},
+      {this->comfort_index_ != nullptr, ElementValueKey::COMFORT_INDEX},
+      {this->comfort_index_description_ != nullptr, ElementValueKey::COMFORT_INDEX_DESCRIPTION},
+      {this->relative_humidity_ != nullptr, ElementValueKey::RELATIVE_HUMIDITY},
+      {this->wind_direction_ != nullptr, ElementValueKey::WIND_DIRECTION},
+      {this->wind_speed_ != nullptr, ElementValueKey::WIND_SPEED},
+      {this->beaufort_scale_ != nullptr, ElementValueKey::BEAUFORT_SCALE},
+      {this->probability_of_precipitation_ != nullptr, ElementValueKey::PROBABILITY_OF_PRECIPITATION},
+      {this->weather_ != nullptr, ElementValueKey::WEATHER},
+      {this->weather_code_ != nullptr, ElementValueKey::WEATHER_CODE},
+      {this->weather_description_ != nullptr, ElementValueKey::WEATHER_DESCRIPTION},
+      {this->weather_icon_ != nullptr, ElementValueKey::WEATHER_ICON},
+      {this->max_temperature_ != nullptr, ElementValueKey::MAX_TEMPERATURE},
+      {this->min_temperature_ != nullptr, ElementValueKey::MIN_TEMPERATURE},
+      {this->max_apparent_temperature_ != nullptr, ElementValueKey::MAX_APPARENT_TEMPERATURE},
+      {this->min_apparent_temperature_ != nullptr, ElementValueKey::MIN_APPARENT_TEMPERATURE},
+      {this->max_comfort_index_ != nullptr, ElementValueKey::MAX_COMFORT_INDEX},
+      {this->max_comfort_index_description_ != nullptr, ElementValueKey::MAX_COMFORT_INDEX_DESCRIPTION},
+      {this->min_comfort_index_ != nullptr, ElementValueKey::MIN_COMFORT_INDEX},
+      {this->min_comfort_index_description_ != nullptr, ElementValueKey::MIN_COMFORT_INDEX_DESCRIPTION},
+      {this->uv_index_ != nullptr, ElementValueKey::UV_INDEX},
+      {this->uv_exposure_level_ != nullptr, ElementValueKey::UV_EXPOSURE_LEVEL},
+  };
+  std::vector<const char *> names;
+  auto add = [&](ElementValueKey key) {
+    const char *name = find_mode_element_name(this->mode_, key);
+    if (name != nullptr && std::find(names.begin(), names.end(), name) == names.end())
+      names.push_back(name);
+  };
+  for (const auto &consumer : consumers) {
+    if (consumer.first)
+      add(consumer.second);
+  }
+  for (ElementValueKey key : this->required_keys_)
+    add(key);
+  return names;
+}
+
 // Attempts to send HTTP request, scheduling retries via set_timeout() on failure.
 void CWATownForecast::try_send_request_(uint32_t attempt) {
   uint32_t retry_count = this->retry_count_.value();
@@ -193,17 +613,56 @@ void CWATownForecast::try_send_request_(uint32_t attempt) {
     if (this->last_success_) {
       this->last_success_->publish_state(now.strftime("%Y-%m-%d %H:%M:%S"));
     }
-
+    std::tm tm = now.to_c_tm();
+    const time_t expiration_time = std::mktime(&tm) + static_cast<time_t>(this->sensor_expiry_.value() / 1000);
+
+#ifdef CWA_SLEEP_STATE
+    if (this->not_modified_ && this->sleep_state_ != nullptr) {
+      // Nothing was downloaded; the snapshot still holds the current data
+      if (!this->publish_snapshot_()) {
+        // publish_snapshot_() dropped the snapshot, so this request goes out
+        // unconditionally and cannot get another 304
+        ESP_LOGW(TAG, "Snapshot incomplete after HTTP 304, fetching in full");
+        this->try_send_request_(attempt);
+        return;
+      }
+      this->sleep_state_->fetched_at = now.timestamp;
+      if (this->prefetch_) {
+        this->schedule_prefetch_(this->sleep_state_->first_slot);
+      }
+      this->save_sleep_state_(false);
+      this->sensor_expiration_time_ = expiration_time;
+      this->on_update_complete_trigger_.trigger();
+      return;
+    }
+    if (this->sleep_state_ != nullptr) {
+      this->sleep_state_->clear_snapshot();
+      this->snapshot_capture_ = true;
+    }
+#endif
     this->publish_states_();
+#ifdef CWA_SLEEP_STATE
+    this->snapshot_capture_ = false;
+#endif
 
-    std::tm tm = now.to_c_tm();
-    time_t now_epoch = std::mktime(&tm);
-    time_t expiry_offset = static_cast<time_t>(this->sensor_expiry_.value() / 1000);
-    this->sensor_expiration_time_ = now_epoch + expiry_offset;
+    if (this->prefetch_) {
+      // Record times are Taiwan wall clock, the schedule runs on UTC
+      this->schedule_prefetch_(TimeField::to_wall_epoch(this->record_().start_time) -
+                               PublicationSchedule::CWA_UTC_OFFSET);
+    }
+#ifdef CWA_SLEEP_STATE
+    if (this->sleep_state_ != nullptr) {
+      this->save_sleep_state_(true);
+    }
+#endif
+
+    this->sensor_expiration_time_ = expiration_time;
 
     if (!this->retain_fetched_data_.value()) {
-      this->record_.release_data();
+      this->clear_record_(this->record_());
     }
+    this->schedule_republish_();
+    this->on_update_complete_trigger_.trigger();
     return;
   }
 
@@ -233,6 +692,7 @@ void CWATownForecast::try_send_request_(uint32_t attempt) {
   this->retry_in_progress_ = false;
   this->status_set_warning();
   this->on_error_trigger_.trigger();
+  this->schedule_prefetch_(0);
 
   auto now = this->rtc_->now();
   if (this->last_error_) {
@@ -247,13 +707,20 @@ void CWATownForecast::try_send_request_(uint32_t attempt) {
   }
 
   if (!this->retain_fetched_data_.value()) {
-    this->record_.release_data();
+    this->clear_record_(this->record_());
+  }
+#ifdef CWA_SLEEP_STATE
+  if (this->sleep_state_ != nullptr) {
+    this->save_sleep_state_(false);
   }
+#endif
+  this->on_update_complete_trigger_.trigger();
 }
 
 // Sends HTTP request to fetch forecast data.
 bool CWATownForecast::send_request_() {
-  if (!this->http_request_) {
+  ForecastSource *source = this->get_source();
+  if (source == &this->http_source_ && !this->http_request_) {
     ESP_LOGE(TAG, "HTTP request component not configured");
     return false;
   }
@@ -263,7 +730,7 @@ bool CWATownForecast::send_request_() {
     return false;
   }
 
-  if (!network::is_connected()) {
+  if (source->needs_network() && !network::is_connected()) {
     ESP_LOGW(TAG, "Network not connected");
     return false;
   }
@@ -272,13 +739,13 @@ bool CWATownForecast::send_request_() {
     case AUTO:
       if (!CWA_PSRAM_AVAILABLE()) {
         ESP_LOGD(TAG, "[Auto] Clear forecast data before sending request");
-        this->record_.release_data();
+        this->record_().release_data();
       }
       break;
 
     case ON:
       ESP_LOGD(TAG, "[On] Clear forecast data before sending request");
-      this->record_.release_data();
+      this->record_().release_data();
       break;
 
     case OFF:
@@ -299,11 +766,19 @@ bool CWATownForecast::send_request_() {
            mode_to_string(mode).c_str());
   ESP_LOGD(TAG, "Resource ID: %s", resource_id);
   std::string encoded_town_name = url_encode(town_name_.value());
-  std::string element_param;
+  const bool derive = this->derives_request_scope_();
+  std::vector<const char *> element_names;
   if (!this->weather_elements_.empty()) {
+    for (const auto &name : this->weather_elements_)
+      element_names.push_back(name.c_str());
+  } else if (derive) {
+    element_names = this->derive_weather_elements_();
+  }
+  std::string element_param;
+  if (!element_names.empty()) {
     std::string joined;
     bool first = true;
-    for (const auto &name : this->weather_elements_) {
+    for (const char *name : element_names) {
       if (!first)
         joined += ",";
       joined += url_encode(name);
@@ -311,12 +786,20 @@ bool CWATownForecast::send_request_() {
     }
     element_param = "&ElementName=" + joined;
   }
-  std::string time_to_param;
+  // Sensors only read the current slot, so without lambdas a short window
+  // is enough; declared lambda keys may look further ahead
+  uint32_t time_to_ms = 0;
   if (time_to_.has_value()) {
+    time_to_ms = time_to_.value();
+  } else if (derive && this->required_keys_.empty()) {
+    time_to_ms = (mode == Mode::THREE_DAYS ? AUTO_TIME_TO_HOURS_3DAYS : AUTO_TIME_TO_HOURS_7DAYS) * 3600 * 1000;
+  }
+  std::string time_to_param;
+  if (time_to_ms > 0) {
     ESPTime now = this->rtc_->now();
     if (now.is_valid()) {
       char buffer[25];
-      unsigned long seconds = time_to_.value() / 1000;
+      unsigned long seconds = time_to_ms / 1000;
       time_t t = now.timestamp + seconds;
       std::tm tm_new = ESPTime::from_epoch_local(t).to_c_tm();
       std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", &tm_new);
@@ -326,21 +809,44 @@ bool CWATownForecast::send_request_() {
       ESP_LOGW(TAG, "Ignoring timeTo parameter, RTC not set");
     }
   }
-  std::string url = "https://opendata.cwa.gov.tw/api/v1/rest/datastore/" + std::string(resource_id) +
-                    "?Authorization=" + api_key_.value() + "&format=JSON&LocationName=" + encoded_town_name +
-                    element_param + time_to_param;
+  std::string url = this->base_url_ + std::string(resource_id) + "?Authorization=" + api_key_.value() +
+                    "&format=JSON&LocationName=" + encoded_town_name + element_param + time_to_param;
 
-  ESP_LOGD(TAG, "Sending query: %s", url.c_str());
+  ESP_LOGD(TAG, "Sending query (%s source): %s", source->name(), url.c_str());
+
+  this->not_modified_ = false;
+#ifdef CWA_SLEEP_STATE
+  bool conditional = false;
+  if (this->sleep_state_ != nullptr) {
+    // A 304 can only be served while the snapshot covers now
+    ESPTime now = this->rtc_->now();
+    conditional = now.is_valid() && this->sleep_state_->covers(now.timestamp);
+    source->set_if_none_match(conditional ? this->sleep_state_->etag : "");
+  }
+#endif
 
-  // Build HTTP request using ESPHome's http_request component
   App.feed_wdt();
-  auto container = this->http_request_->get(url);
+  this->fetch_stats_ = FetchStats{};
+  uint32_t connect_start = millis();
+  auto container = source->open(url);
+  this->fetch_stats_.connect_ms = millis() - connect_start;
 
   bool request_success = false;
   uint64_t hash_code = 0;
 
   if (container == nullptr) {
     ESP_LOGE(TAG, "HTTP request failed: no response container");
+#ifdef CWA_SLEEP_STATE
+  } else if (container->status_code == 304) {
+    if (conditional) {
+      ESP_LOGD(TAG, "HTTP 304, forecast not modified");
+      this->not_modified_ = true;
+      request_success = true;
+    } else {
+      // No snapshot to fall back on
+      ESP_LOGE(TAG, "HTTP 304 to an unconditional request");
+    }
+#endif
   } else if (container->status_code != 200) {
     ESP_LOGE(TAG, "HTTP request failed with code: %d", container->status_code);
   } else {
@@ -348,13 +854,18 @@ bool CWATownForecast::send_request_() {
     ESP_LOGD(TAG, "HTTP 200 OK, content_length: %zu", container->content_length);
 
     // Wrap container with our stream adapter for streaming JSON parsing
-    HttpStreamAdapter stream(container, 1024, this->http_request_->get_timeout());  // 1KB buffer
+    const uint32_t timeout = this->http_request_ ? this->http_request_->get_timeout() : 10000;
+    HttpStreamAdapter stream(container, HttpStreamAdapter::DEFAULT_BUFFER_SIZE, timeout);
 
     // Add timeout protection for response processing
     unsigned long process_start = millis();
-    uint32_t max_process_time = this->http_request_->get_timeout() + 10000;  // Add 10s buffer for processing
+    uint32_t max_process_time = timeout + 10000;  // Add 10s buffer for processing
 
     request_success = this->process_response_(stream, hash_code);
+#ifdef CWA_ALLOC_TRACE
+    // After process_response_() so the slot document and released record frees are counted
+    AllocTrace::dump(request_success ? "parse" : "failed parse");
+#endif
 
     unsigned long process_duration = millis() - process_start;
     if (process_duration > max_process_time) {
@@ -363,9 +874,24 @@ bool CWATownForecast::send_request_() {
       request_success = false;
     }
 
-    ESP_LOGD(TAG, "Total bytes read from stream: %zu", stream.getBytesRead());
+    if (!request_success && stream.isTruncated()) {
+      ESP_LOGE(TAG, "Response body incomplete after %zu of %zu bytes", stream.getBytesRead(),
+               container->content_length);
+    }
+    ESP_LOGD(TAG, "Total bytes read from stream: %zu (skipped: %zu, parsed: %zu)", stream.getBytesRead(),
+             stream.getBytesSkipped(), stream.getBytesRead() - stream.getBytesSkipped());
     ESP_LOGD(TAG, "Response processing duration: %lu ms", process_duration);
 
+    FetchStats &stats = this->fetch_stats_;
+    stats.bytes_read = stream.getBytesRead();
+    stats.bytes_skipped = stream.getBytesSkipped();
+    stats.first_byte_ms = stream.getFirstByteDelay();
+    stats.download_ms = stream.getReadTime();
+    stats.parse_ms = process_duration > stats.download_ms ? process_duration - stats.download_ms : 0;
+    ESP_LOGD(TAG, "Connect: %" PRIu32 " ms, first byte: %" PRIu32 " ms, download: %" PRIu32 " ms, parse: %" PRIu32
+             " ms, hash: %" PRIu32 " us",
+             stats.connect_ms, stats.first_byte_ms, stats.download_ms, stats.parse_ms, stats.hash_us);
+
     // Drain any remaining buffered data
     stream.drainBuffer();
   }
@@ -374,11 +900,14 @@ bool CWATownForecast::send_request_() {
     container->end();
   }
   container.reset();
+  this->publish_fetch_stats_();
 
   if (request_success) {
-    if (this->check_changes(hash_code)) {
+    if (this->not_modified_) {
+      ESP_LOGD(TAG, "No data change detected");
+    } else if (this->check_changes(hash_code)) {
       ESP_LOGD(TAG, "Triggering on_data_change");
-      this->on_data_change_trigger_.trigger(this->record_);
+      this->on_data_change_trigger_.trigger(this->record_());
     } else {
       ESP_LOGD(TAG, "No data change detected");
     }
@@ -389,9 +918,16 @@ bool CWATownForecast::send_request_() {
   }
 }
 
-// Parses ISO8601 date/time string into std::tm.
-static bool parse_iso8601(const char *s, std::tm &tm) {
-  std::memset(&tm, 0, sizeof(tm));
+// Parses an ISO8601 date/time string into out. CWA's fixed layout takes the
+// digit-position fast path; anything else goes through the lenient sscanf
+// parse, which ignores any UTC offset.
+static bool parse_iso8601(const char *s, TimeField &out) {
+  time_t wall_epoch;
+  if (TimeField::parse_iso8601(s, wall_epoch)) {
+    out = TimeField(wall_epoch);
+    return out.is_valid();  // false outside TimeField's 2000..2136 range
+  }
+  std::tm tm{};
   int year, month, day, hour = 0, min = 0, sec = 0;
   int matched;
   if (std::strchr(s, 'T') != nullptr) {
@@ -409,50 +945,157 @@ static bool parse_iso8601(const char *s, std::tm &tm) {
   tm.tm_hour = hour;
   tm.tm_min = min;
   tm.tm_sec = sec;
+  out = tm;
+  return out.is_valid();
+}
+
+// Skips JSON whitespace and returns the next byte (-1 at EOF) unconsumed.
+static int skip_whitespace(HttpStreamAdapter &stream) {
+  int c;
+  while ((c = stream.peek()) == ' ' || c == '\n' || c == '\r' || c == '\t')
+    stream.read();
+  return c;
+}
+
+// Finds key (e.g. "\"Latitude\":") and reads its scalar value: a string's
+// contents, or a bare number/true/false for producers that do not quote
+// them. Whitespace after the colon is allowed, as in pretty-printed JSON.
+static bool find_scalar(HttpStreamAdapter &stream, const char *key, std::string &out) {
+  if (!stream.find(key))
+    return false;
+  if (skip_whitespace(stream) == '"') {
+    stream.read();
+    out = stream.readStringUntil('"');
+    return true;
+  }
+  out.clear();
+  int c;
+  while ((c = stream.peek()) != -1 && (std::isalnum(c) || c == '-' || c == '+' || c == '.') && out.size() < 32)
+    out += static_cast<char>(stream.read());
   return true;
 }
 
-bool CWATownForecast::parse_to_record(HttpStreamAdapter &stream, Record &record, uint64_t &hash_code) {
-  if (!stream.find("\"success\":")) {
+// Containers still open after the WeatherElement array: the root object,
+// records, Locations, its element, Location and its element
+static constexpr int WEATHER_ELEMENT_DEPTH = 6;
+
+// Reads to the end of the document from inside depth open containers,
+// skipping whatever else they hold. False if the stream ends first.
+static bool read_to_document_end(HttpStreamAdapter &stream, int depth) {
+  bool in_string = false;
+  bool escaped = false;
+  int c;
+  while (depth > 0 && (c = stream.read()) != -1) {
+    if (in_string) {
+      if (escaped) {
+        escaped = false;
+      } else if (c == '\\') {
+        escaped = true;
+      } else if (c == '"') {
+        in_string = false;
+      }
+    } else if (c == '"') {
+      in_string = true;
+    } else if (c == '{' || c == '[') {
+      ++depth;
+    } else if (c == '}' || c == ']') {
+      --depth;
+    }
+  }
+  return depth == 0;
+}
+
+// Finds key (e.g. "\"Time\":") and consumes the '[' opening its array value.
+static bool find_array(HttpStreamAdapter &stream, const char *key) {
+  if (!stream.find(key) || skip_whitespace(stream) != '[')
+    return false;
+  stream.read();
+  return true;
+}
+
+// Parser body for one mode: M fixes the recognized ElementValue keys and the
+// pre-sizing at compile time.
+template<Mode M> bool CWATownForecast::parse_mode_(HttpStreamAdapter &stream, Record &record, uint64_t &hash_code) {
+  std::string success_val;
+  if (!find_scalar(stream, "\"success\":", success_val)) {
     ESP_LOGE(TAG, "Could not find success field");
     return false;
   }
-  std::string success_val = stream.readStringUntil(',');
-  if (success_val != "\"true\"") {
+  if (success_val != "true") {
     ESP_LOGE(TAG, "API response 'success' is not true: %s", success_val.c_str());
     return false;
   }
 
-  record.mode = this->mode_;
-  record.weather_elements.reserve(this->mode_ == Mode::THREE_DAYS ? WEATHER_ELEMENT_NAMES_3DAYS_SIZE
-                                                                  : WEATHER_ELEMENT_NAMES_7DAYS_SIZE);
-  record.string_pool = std::make_shared<StringPool>();
+  record.reset();
+  record.mode = M;
+  // Continue from the live record's generation so caches keyed on it never
+  // mistake the new data for the old
+  record.generation = this->record_().generation + 1;
+  record.weather_elements.reserve(M == Mode::THREE_DAYS ? WEATHER_ELEMENT_NAMES_3DAYS_SIZE
+                                                        : WEATHER_ELEMENT_NAMES_7DAYS_SIZE);
+  if (!record.string_pool)
+    record.string_pool = std::make_shared<StringPool>();
   StringPool &pool = *record.string_pool;
 
-  if (!stream.find("\"LocationsName\":\"")) {
+  // Memory budget: the element table and a quarter of the budget for the
+  // string pool are set aside up front, the rest caps the slots each element
+  // keeps. Over budget, the latest (far-future) slots are dropped first, then
+  // low-priority values once the pool is three quarters full. The budget
+  // covers the Record only, not the slot document or the stream buffer.
+  const bool budgeted = this->memory_budget_ > 0;
+  size_t slot_limit = 0;
+  size_t low_priority_pool_limit = 0;
+  if (budgeted) {
+    size_t element_count = this->weather_elements_.size();
+    if (element_count == 0 && this->derives_request_scope_())
+      element_count = this->derive_weather_elements_().size();
+    if (element_count == 0)
+      element_count = M == Mode::THREE_DAYS ? WEATHER_ELEMENT_NAMES_3DAYS_SIZE : WEATHER_ELEMENT_NAMES_7DAYS_SIZE;
+    const size_t pool_limit = this->memory_budget_ / 4;
+    const size_t fixed = element_count * sizeof(WeatherElement) + pool_limit;
+    slot_limit = this->memory_budget_ > fixed ? (this->memory_budget_ - fixed) / (element_count * sizeof(Time)) : 0;
+    if (slot_limit == 0) {
+      ESP_LOGW(TAG, "Memory budget of %" PRIu32 " bytes is too small; keeping one slot per element",
+               this->memory_budget_);
+      slot_limit = 1;
+    }
+    low_priority_pool_limit = pool_limit * 3 / 4;
+    pool.set_limit(pool_limit);
+    record.weather_elements.reserve(element_count);
+    ESP_LOGD(TAG, "Memory budget: %zu slots per element, %zu byte string pool", slot_limit, pool_limit);
+  } else {
+    pool.set_limit(0);
+  }
+
+  const bool track_heap = this->tracks_parse_heap_();
+  if (track_heap) {
+    this->fetch_stats_.free_heap_before_parse = heap_caps_get_free_size(MALLOC_CAP_8BIT | MALLOC_CAP_INTERNAL);
+    this->fetch_stats_.min_free_heap = this->fetch_stats_.free_heap_before_parse;
+    this->fetch_stats_.min_largest_free_block = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT | MALLOC_CAP_INTERNAL);
+  }
+
+  if (!find_scalar(stream, "\"LocationsName\":", record.locations_name)) {
     ESP_LOGE(TAG, "Could not find LocationsName");
     return false;
   }
-  record.locations_name = stream.readStringUntil('"');
   if (record.locations_name.empty()) {
     ESP_LOGW(TAG, "LocationsName value is empty (city text_sensor will be empty)");
   }
 
-  if (!stream.find("\"LocationName\":\"")) {
+  if (!find_scalar(stream, "\"LocationName\":", record.location_name)) {
     ESP_LOGE(TAG, "Could not find LocationName");
     return false;
   }
-  record.location_name = stream.readStringUntil('"');
   if (record.location_name.empty()) {
     ESP_LOGW(TAG, "LocationName value is empty (town text_sensor will be empty)");
   }
 
   auto parse_coordinate = [&](const char *key, double &out) -> bool {
-    if (!stream.find(key)) {
+    std::string str;
+    if (!find_scalar(stream, key, str)) {
       ESP_LOGE(TAG, "Could not find %s", key);
       return false;
     }
-    std::string str = stream.readStringUntil('"');
     const char *cstr = str.c_str();
     char *end = nullptr;
     double val = std::strtod(cstr, &end);
@@ -465,12 +1108,12 @@ bool CWATownForecast::parse_to_record(HttpStreamAdapter &stream, Record &record,
     return true;
   };
 
-  if (!parse_coordinate("\"Latitude\":\"", record.latitude))
+  if (!parse_coordinate("\"Latitude\":", record.latitude))
     return false;
-  if (!parse_coordinate("\"Longitude\":\"", record.longitude))
+  if (!parse_coordinate("\"Longitude\":", record.longitude))
     return false;
 
-  if (!stream.find("\"WeatherElement\":[")) {
+  if (!find_array(stream, "\"WeatherElement\":")) {
     ESP_LOGE(TAG, "Could not find WeatherElement array");
     return false;
   }
@@ -480,7 +1123,29 @@ bool CWATownForecast::parse_to_record(HttpStreamAdapter &stream, Record &record,
   ESP_LOGD(TAG, "Sunset Latitude: %f, Longitude: %f, Offset: %.0f", record.latitude, record.longitude,
            record.timezone_offset);
 
-#ifdef USE_PSRAM
+#ifdef CWA_ALLOC_TRACE
+  AllocTrace::reset();
+  // Counts slot document allocations, placed like the untraced allocator would
+  struct TracingJsonAllocator : ArduinoJson::Allocator {
+    uint32_t caps = CWA_PSRAM_AVAILABLE() ? MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT : MALLOC_CAP_DEFAULT;
+    void *allocate(size_t size) override {
+      void *ptr = heap_caps_malloc(size, this->caps);
+      AllocTrace::on_alloc(AllocCategory::JSON, ptr, size);
+      return ptr;
+    }
+    void deallocate(void *ptr) override {
+      AllocTrace::on_free(AllocCategory::JSON, ptr);
+      heap_caps_free(ptr);
+    }
+    void *reallocate(void *ptr, size_t new_size) override {
+      void *out = heap_caps_realloc(ptr, new_size, this->caps);
+      AllocTrace::on_alloc(AllocCategory::JSON, out, new_size, true);
+      return out;
+    }
+  };
+  TracingJsonAllocator tracing_json_allocator;
+  ArduinoJson::JsonDocument time_obj(&tracing_json_allocator);
+#elif defined(USE_PSRAM)
   // PSRAM-aware allocator for ArduinoJson to offload JSON parsing buffers from internal RAM
   struct SpiRamJsonAllocator : ArduinoJson::Allocator {
     void *allocate(size_t size) override { return heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT); }
@@ -494,37 +1159,54 @@ bool CWATownForecast::parse_to_record(HttpStreamAdapter &stream, Record &record,
 #else
   ArduinoJson::JsonDocument time_obj;
 #endif
+  // Only these slot fields are stored; anything else a response adds is
+  // skipped by the deserializer rather than allocated
+  ArduinoJson::JsonDocument slot_filter;
+  slot_filter["DataTime"] = true;
+  slot_filter["StartTime"] = true;
+  slot_filter["EndTime"] = true;
+  slot_filter["ElementValue"] = true;
   bool has_valid_data = false;  // Track if we have at least one element with valid data
 
-  auto add_element_value = [&pool](Time &t, ElementValueKey key, const char *value) {
-    if (!t.element_values.emplace_back(key, pool.intern(value))) {
+  auto intern_value = [&](ElementValueKey key, const char *value) -> StringPoolOffset {
+    if (budgeted && is_low_priority_element_value_key(key))
+      return pool.intern(value, low_priority_pool_limit);
+    return pool.intern(value);
+  };
+  auto add_element_value = [&](Time &t, ElementValueKey key, const char *value) {
+    if (!t.element_values.emplace_back(key, intern_value(key, value))) {
       ESP_LOGW(TAG, "Too many element values in one time slot; dropping %s", element_value_key_to_string(key).c_str());
     }
   };
 
   do {
     App.feed_wdt();
-    WeatherElement we;
-    if (!stream.find("\"ElementName\":\"")) {
+    // Reuses a spare element (and its times capacity) from an earlier parse
+    WeatherElement &we = record.add_element();
+    we.string_pool = record.string_pool;
+    // The name is only needed here: elements are identified by id from now on
+    std::string element_name;
+    if (!find_scalar(stream, "\"ElementName\":", element_name)) {
       ESP_LOGE(TAG, "Could not find ElementName");
       return false;
     }
-    we.element_name = stream.readStringUntil('"');
-    if (!stream.find("\"Time\":[")) {
-      ESP_LOGE(TAG, "Could not find Time array for %s", we.element_name.c_str());
+    we.id = parse_weather_element_id(element_name.c_str());
+    if (!find_array(stream, "\"Time\":")) {
+      ESP_LOGE(TAG, "Could not find Time array for %s", element_name.c_str());
       return false;
     }
 
-    ESP_LOGV(TAG, "Processing Weather Element: %s", we.element_name.c_str());
+    ESP_LOGV(TAG, "Processing Weather Element: %s", element_name.c_str());
 
     // check for empty array
-    int next = stream.peek();
+    int next = skip_whitespace(stream);
     if (next == ']') {
       ESP_LOGW(TAG,
                "Empty Time array for %s: element will not be added to record; "
                "dependent sensors will publish NaN/empty and show Unavailable",
-               we.element_name.c_str());
+               element_name.c_str());
       stream.read();
+      record.pop_element();
       continue;
     }
 
@@ -533,15 +1215,22 @@ bool CWATownForecast::parse_to_record(HttpStreamAdapter &stream, Record &record,
 
     // Pre-size for typical slot counts (3-day 3-hourly elements: 32 slots,
     // 7-day half-day intervals: ~14); 3-day hourly elements (~56 slots) grow
-    // once more from here
-    we.times.reserve(this->mode_ == Mode::THREE_DAYS ? 32 : 16);
+    // once more from here. A memory budget fixes the capacity instead.
+    we.times.reserve(budgeted ? slot_limit : (M == Mode::THREE_DAYS ? 32 : 16));
 
     do {
       time_obj.clear();
       ESP_LOGV(TAG, "Parsing JSON with %d bytes available", stream.available());
 
-      // The ReadLoggingStream will output the stream content to Serial for debugging
-      DeserializationError err = deserializeJson(time_obj, stream);
+      // The read limit bounds the slot document whatever the response holds
+      stream.setReadLimit(MAX_SLOT_BYTES);
+      DeserializationError err = deserializeJson(time_obj, stream, DeserializationOption::Filter(slot_filter));
+      const bool over_limit = stream.readLimitReached();
+      stream.clearReadLimit();
+      if (err && over_limit) {
+        ESP_LOGE(TAG, "Time slot of %s exceeds %zu bytes; aborting parse", element_name.c_str(), MAX_SLOT_BYTES);
+        return false;
+      }
       if (err) {
         ESP_LOGE(TAG, "JSON parsing failed: %s", err.c_str());
         ESP_LOGE(TAG, "Stream available bytes before error: %d", stream.available());
@@ -561,42 +1250,47 @@ bool CWATownForecast::parse_to_record(HttpStreamAdapter &stream, Record &record,
         }
       }
 
+      // Slots arrive in time order, so the ones over budget are the latest
+      if (budgeted && we.times.size() >= slot_limit) {
+        ++this->fetch_stats_.dropped_slots;
+        continue;
+      }
+
       Time ts;
-      ts.string_pool = record.string_pool;
 
       if (time_obj["DataTime"].is<const char *>()) {
         const char *tmp = time_obj["DataTime"].as<const char *>();
-        std::tm temp_tm;
-        if (!parse_iso8601(tmp, temp_tm)) {
+        if (!parse_iso8601(tmp, ts.data_time)) {
           ESP_LOGE(TAG, "Could not parse DataTime: %s", tmp);
           return false;
         }
-        ts.data_time = temp_tm;
       }
       if (time_obj["StartTime"].is<const char *>()) {
         const char *tmp = time_obj["StartTime"].as<const char *>();
-        std::tm temp_tm;
-        if (!parse_iso8601(tmp, temp_tm)) {
+        if (!parse_iso8601(tmp, ts.start_time_data)) {
           ESP_LOGE(TAG, "Could not parse StartTime: %s", tmp);
           return false;
         }
-        ts.start_time_data = temp_tm;
       }
       if (time_obj["EndTime"].is<const char *>()) {
         const char *tmp = time_obj["EndTime"].as<const char *>();
-        std::tm temp_tm;
-        if (!parse_iso8601(tmp, temp_tm)) {
+        if (!parse_iso8601(tmp, ts.end_time_data)) {
           ESP_LOGE(TAG, "Could not parse EndTime: %s", tmp);
           return false;
         }
-        ts.end_time_data = temp_tm;
+      }
+
+      // Matching and range lookups need a point or a complete interval
+      if (!ts.data_time.is_valid() && !(ts.start_time_data.is_valid() && ts.end_time_data.is_valid())) {
+        ESP_LOGW(TAG, "Time slot of %s has no DataTime or StartTime/EndTime; skipping it", element_name.c_str());
+        continue;
       }
 
       // Process element values
       for (ArduinoJson::JsonObject val_obj : time_obj["ElementValue"].as<ArduinoJson::JsonArray>()) {
         for (ArduinoJson::JsonPair kv : val_obj) {
           ElementValueKey evk;
-          if (parse_element_value_key(kv.key().c_str(), evk)) {
+          if (parse_mode_element_value_key<M>(kv.key().c_str(), evk)) {
             const char *value = kv.value().as<const char *>();
             std::string value_buf;
             if (value == nullptr) {
@@ -607,13 +1301,13 @@ bool CWATownForecast::parse_to_record(HttpStreamAdapter &stream, Record &record,
             auto it = std::find_if(ts.element_values.begin(), ts.element_values.end(),
                                    [&](const ElementValueEntry &p) { return p.key == static_cast<uint8_t>(evk); });
             if (it != ts.element_values.end()) {
-              it->offset = pool.intern(value);
+              it->offset = intern_value(evk, value);
             } else {
               add_element_value(ts, evk, value);
             }
 
             // Special handling for weather codes to generate weather icons
-            if (we.element_name == WEATHER_ELEMENT_NAME_WEATHER && evk == ElementValueKey::WEATHER_CODE) {
+            if (we.id == WeatherElementId::WEATHER && evk == ElementValueKey::WEATHER_CODE) {
               std::tm t = ts.to_tm();
               const char *icon = find_weather_icon_name(value, record.is_daytime(t), IconSet::MDI);
               if (strlen(icon) == 0) {
@@ -628,9 +1322,41 @@ bool CWATownForecast::parse_to_record(HttpStreamAdapter &stream, Record &record,
         }
       }
       we.times.push_back(std::move(ts));
+      ++this->fetch_stats_.slots_parsed;
+      if (track_heap)
+        this->sample_parse_heap_(false);
     } while (stream.findUntil(",", "]"));
-    record.weather_elements.push_back(std::move(we));
+    // The array ends in ']' with the response's closing brackets after it;
+    // EOF here means the response was cut off at a slot boundary
+    if (stream.peek() == -1) {
+      ESP_LOGE(TAG, "Response truncated in the Time array of %s", element_name.c_str());
+      return false;
+    }
+    // Range lookups binary-search the slots, so restore time order if the
+    // response broke it
+    auto earlier = [](const Time &a, const Time &b) { return a.to_epoch() < b.to_epoch(); };
+    if (!std::is_sorted(we.times.begin(), we.times.end(), earlier)) {
+      ESP_LOGW(TAG, "Time slots of %s are out of order; sorting them", element_name.c_str());
+      std::sort(we.times.begin(), we.times.end(), earlier);
+    }
+    // The largest-block query walks the heap, so it runs once per element
+    if (track_heap)
+      this->sample_parse_heap_(true);
+    if (we.id == WeatherElementId::UNKNOWN) {
+      ESP_LOGW(TAG, "Unknown weather element %s; ignoring it", element_name.c_str());
+      record.pop_element();
+      continue;
+    }
   } while (stream.findUntil(",", "]"));
+  if (stream.peek() == -1) {
+    ESP_LOGE(TAG, "Response truncated in the WeatherElement array");
+    return false;
+  }
+  // A cut within the closing brackets would otherwise pass as complete
+  if (!read_to_document_end(stream, WEATHER_ELEMENT_DEPTH)) {
+    ESP_LOGE(TAG, "Response truncated after the WeatherElement array");
+    return false;
+  }
 
   // Check if we got any valid data
   if (!has_valid_data) {
@@ -638,30 +1364,17 @@ bool CWATownForecast::parse_to_record(HttpStreamAdapter &stream, Record &record,
     return false;
   }
 
+  record.index_elements();
+
   // Determine start and end time for the entire record
-  bool first_time = true;
-  std::time_t min_epoch = 0;
-  std::time_t max_epoch = 0;
-  for (const auto &we : record.weather_elements) {
-    for (const auto &t : we.times) {
-      const TimeField &primary = t.primary_field();
-      if (!primary.is_valid()) {
-        continue;
-      }
-      std::time_t cand_epoch = primary.epoch();
-      if (first_time || cand_epoch < min_epoch) {
-        min_epoch = cand_epoch;
-      }
-      std::time_t end_cand = t.end_time_data.is_valid() ? t.end_time_data.epoch() : cand_epoch;
-      if (first_time || end_cand > max_epoch) {
-        max_epoch = end_cand;
-      }
-      first_time = false;
-    }
-  }
-  if (!first_time) {
-    record.start_time = TimeField(min_epoch).to_tm();
-    record.end_time = TimeField(max_epoch).to_tm();
+  record.update_time_bounds();
+  record.build_daily_summaries();
+  ESP_LOGD(TAG, "String pool: %zu bytes, %" PRIu32 " values dropped", pool.size(), pool.dropped_values());
+  this->fetch_stats_.string_pool_bytes = pool.size();
+  this->fetch_stats_.dropped_values = pool.dropped_values();
+  if (budgeted && (this->fetch_stats_.dropped_slots > 0 || this->fetch_stats_.dropped_values > 0)) {
+    ESP_LOGW(TAG, "Memory budget exceeded: dropped %" PRIu32 " far-future slots and %" PRIu32 " values",
+             this->fetch_stats_.dropped_slots, this->fetch_stats_.dropped_values);
   }
 
   // Set the updated time to current time
@@ -670,6 +1383,7 @@ bool CWATownForecast::parse_to_record(HttpStreamAdapter &stream, Record &record,
   }
 
   // Calculate hash code for change detection
+  uint32_t hash_start = micros();
   uint64_t new_hash = 0;
   const uint64_t salt = 0x9e3779b97f4a7c15ULL;
   auto combine_hash = [&](uint64_t h) { new_hash ^= h + salt + (new_hash << 6) + (new_hash >> 2); };
@@ -692,7 +1406,7 @@ bool CWATownForecast::parse_to_record(HttpStreamAdapter &stream, Record &record,
   combine_chars(record.locations_name.c_str(), record.locations_name.size());
   combine_chars(record.location_name.c_str(), record.location_name.size());
   for (const auto &we : record.weather_elements) {
-    combine_chars(we.element_name.c_str(), we.element_name.size());
+    combine_int(static_cast<uint64_t>(we.id));
     for (const auto &ts : we.times) {
       if (ts.data_time.is_valid()) {
         combine_int(static_cast<uint64_t>(ts.data_time.epoch()));
@@ -710,47 +1424,253 @@ bool CWATownForecast::parse_to_record(HttpStreamAdapter &stream, Record &record,
   }
 
   hash_code = new_hash;
+  this->fetch_stats_.hash_us = micros() - hash_start;
   return true;
 }
 
-// Processes the HTTP response and parses forecast data.
-// Two strategies: PSRAM devices parse into a PSRAM-allocated temp record for
-// atomicity; non-PSRAM devices clear existing data, parse in place, and
-// discard partial results on failure.
+// Dispatches to the parser instantiated for the configured mode. Code
+// generation defines CWA_MODE_THREE_DAYS / CWA_MODE_SEVEN_DAYS for the modes
+// in use, so a single-mode firmware only carries one parser.
+bool CWATownForecast::parse_to_record(HttpStreamAdapter &stream, Record &record, uint64_t &hash_code) {
+#if !defined(CWA_MODE_THREE_DAYS) && !defined(CWA_MODE_SEVEN_DAYS)
+#define CWA_MODE_THREE_DAYS
+#define CWA_MODE_SEVEN_DAYS
+#endif
+  switch (this->mode_) {
+#ifdef CWA_MODE_THREE_DAYS
+    case Mode::THREE_DAYS:
+      return this->parse_mode_<Mode::THREE_DAYS>(stream, record, hash_code);
+#endif
+#ifdef CWA_MODE_SEVEN_DAYS
+    case Mode::SEVEN_DAYS:
+      return this->parse_mode_<Mode::SEVEN_DAYS>(stream, record, hash_code);
+#endif
+    default:
+      ESP_LOGE(TAG, "Parser for mode %s not compiled in", mode_to_string(this->mode_).c_str());
+      return false;
+  }
+}
+
+// Tracks the low-water marks of internal heap while parsing.
+void CWATownForecast::sample_parse_heap_(bool largest_block) {
+  FetchStats &stats = this->fetch_stats_;
+  size_t free_heap = heap_caps_get_free_size(MALLOC_CAP_8BIT | MALLOC_CAP_INTERNAL);
+  if (free_heap < stats.min_free_heap)
+    stats.min_free_heap = free_heap;
+  if (largest_block) {
+    size_t block = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT | MALLOC_CAP_INTERNAL);
+    if (block < stats.min_largest_free_block)
+      stats.min_largest_free_block = block;
+  }
+}
+
+// Publishes the diagnostic sensors for the last fetch.
+void CWATownForecast::publish_fetch_stats_() {
+  const FetchStats &stats = this->fetch_stats_;
+  if (this->connect_time_)
+    this->connect_time_->publish_state(stats.connect_ms);
+  if (this->first_byte_time_)
+    this->first_byte_time_->publish_state(stats.first_byte_ms);
+  if (this->download_time_)
+    this->download_time_->publish_state(stats.download_ms);
+  if (this->parse_time_)
+    this->parse_time_->publish_state(stats.parse_ms);
+  if (this->hash_time_)
+    this->hash_time_->publish_state(stats.hash_us / 1000.0f);
+  if (this->bytes_read_)
+    this->bytes_read_->publish_state(stats.bytes_read);
+  if (this->bytes_skipped_)
+    this->bytes_skipped_->publish_state(stats.bytes_skipped);
+  if (this->slots_parsed_)
+    this->slots_parsed_->publish_state(stats.slots_parsed);
+  if (this->string_pool_size_)
+    this->string_pool_size_->publish_state(stats.string_pool_bytes);
+  if (this->parse_peak_heap_)
+    this->parse_peak_heap_->publish_state(stats.peak_heap_usage());
+  if (this->parse_largest_free_block_)
+    this->parse_largest_free_block_->publish_state(stats.min_largest_free_block);
+  if (this->dropped_slots_)
+    this->dropped_slots_->publish_state(stats.dropped_slots);
+  if (this->dropped_values_)
+    this->dropped_values_->publish_state(stats.dropped_values);
+}
+
+// Processes the HTTP response and parses forecast data into the inactive
+// record slot, which becomes the active one only when the parse succeeds; the
+// live data is untouched by a failed or partial parse, unless early_data_clear
+// already released it to keep one record resident while parsing. The retired
+// slot is emptied per retain_capacity: kept allocations let the next poll
+// refill it without allocating, freeing them leaves one record resident
+// between polls.
 bool CWATownForecast::process_response_(HttpStreamAdapter &stream, uint64_t &hash_code) {
-  if (CWA_PSRAM_AVAILABLE()) {
-    ESP_LOGD(TAG, "Using PSRAM buffer strategy");
-    Record *temp = static_cast<Record *>(heap_caps_malloc(sizeof(Record), MALLOC_CAP_SPIRAM));
-    if (temp) {
-      new (temp) Record();
-      bool ok = parse_to_record(stream, *temp, hash_code);
-      if (ok) {
-        this->record_ = std::move(*temp);
-      }
-      temp->~Record();
-      heap_caps_free(temp);
-      return ok;
-    }
-    ESP_LOGW(TAG, "PSRAM allocation failed, falling back to in-place strategy");
+  Record &next = this->inactive_record_();
+  // A feed starts with its magic, a CWA response with '{'
+  bool ok = stream.peek() == FEED_MAGIC[0] ? this->load_feed_(stream, next, hash_code)
+                                           : parse_to_record(stream, next, hash_code);
+  if (ok) {
+    this->active_record_ ^= 1;
+    ESP_LOGD(TAG, "Switched to record slot %u (generation %" PRIu32 ")", this->active_record_,
+             this->record_().generation);
+#ifdef CWA_FEED_SERVER
+    if (this->feed_base_ != nullptr)
+      this->publish_feed_(hash_code);
+#endif
+  } else {
+    ESP_LOGW(TAG, "Parse failed, keeping previous record");
   }
+  this->clear_record_(this->inactive_record_());
+  return ok;
+}
 
-  ESP_LOGD(TAG, "Using in-place parse strategy");
-  this->record_.release_data();
+// Loads a feed served by another node (see Record::encode_feed()) instead of
+// parsing JSON: the string pool is read straight into the record's buffer and
+// slots are rebuilt field by field. Everything is validated, so a truncated
+// or foreign feed fails like a bad response and the live record stays.
+bool CWATownForecast::load_feed_(HttpStreamAdapter &stream, Record &record, uint64_t &hash_code) {
+  FeedReader in(stream);
+  char magic[sizeof(FEED_MAGIC)];
+  if (!in.bytes(magic, sizeof(magic)) || memcmp(magic, FEED_MAGIC, sizeof(magic)) != 0) {
+    ESP_LOGE(TAG, "Response is not a forecast feed");
+    return false;
+  }
+  const uint8_t version = in.u8();
+  const uint8_t mode = in.u8();
+  const uint8_t offset_bytes = in.u8();
+  const uint8_t element_count = in.u8();
+  const uint64_t feed_hash = in.u64();
+  const int64_t updated_epoch = static_cast<int64_t>(in.u64());
+  if (!in.ok() || version != FEED_VERSION) {
+    ESP_LOGE(TAG, "Unsupported feed version %u (expected %u)", version, FEED_VERSION);
+    return false;
+  }
+  if (mode != static_cast<uint8_t>(this->mode_)) {
+    ESP_LOGE(TAG, "Feed carries %s data, configured mode is %s", mode_to_string(static_cast<Mode>(mode)).c_str(),
+             mode_to_string(this->mode_).c_str());
+    return false;
+  }
+  if (offset_bytes != 2 && offset_bytes != 4) {
+    ESP_LOGE(TAG, "Malformed feed: %u-byte offsets", offset_bytes);
+    return false;
+  }
 
-  if (!parse_to_record(stream, this->record_, hash_code)) {
-    ESP_LOGW(TAG, "Parse failed, clearing record");
-    this->record_.release_data();
+  record.reset();
+  record.mode = this->mode_;
+  record.generation = this->record_().generation + 1;
+  record.latitude = in.f64();
+  record.longitude = in.f64();
+  in.str(record.locations_name);
+  in.str(record.location_name);
+  if (!record.string_pool)
+    record.string_pool = std::make_shared<StringPool>();
+  StringPool &pool = *record.string_pool;
+  // The budget's string pool share still applies; a feed over it is refused
+  pool.set_limit(this->memory_budget_ / 4);
+  const uint32_t pool_size = in.u32();
+  if (!in.ok() || !pool.assign(pool_size, [&](char *dst, size_t n) { return in.bytes(dst, n); })) {
+    ESP_LOGE(TAG, "Feed string pool of %" PRIu32 " bytes is truncated, malformed or too large", pool_size);
+    return false;
+  }
+
+  record.weather_elements.reserve(element_count);
+  for (uint8_t e = 0; e < element_count; ++e) {
+    App.feed_wdt();
+    WeatherElement &we = record.add_element();
+    we.string_pool = record.string_pool;
+    const uint8_t id = in.u8();
+    const uint16_t slot_count = in.u16();
+    if (!in.ok() || id >= WEATHER_ELEMENT_ID_COUNT) {
+      ESP_LOGE(TAG, "Malformed feed: element %u", e);
+      return false;
+    }
+    we.id = static_cast<WeatherElementId>(id);
+    we.times.reserve(slot_count);
+    for (uint16_t i = 0; i < slot_count; ++i) {
+      const uint8_t flags = in.u8();
+      Time ts;
+      if (flags & FEED_DATA_TIME)
+        ts.data_time = TimeField(static_cast<time_t>(FEED_EPOCH_BASE + in.u32()));
+      if (flags & FEED_START_TIME)
+        ts.start_time_data = TimeField(static_cast<time_t>(FEED_EPOCH_BASE + in.u32()));
+      if (flags & FEED_END_TIME)
+        ts.end_time_data = TimeField(static_cast<time_t>(FEED_EPOCH_BASE + in.u32()));
+      for (uint8_t v = 0, n = flags >> 4; v < n; ++v) {
+        const uint8_t key = in.u8();
+        const uint32_t offset = offset_bytes == 2 ? in.u16() : in.u32();
+        if (key >= ELEMENT_VALUE_KEY_COUNT || offset >= pool.size() ||
+            !pool.is_string_start(static_cast<StringPoolOffset>(offset)) ||
+            !ts.element_values.emplace_back(static_cast<ElementValueKey>(key), static_cast<StringPoolOffset>(offset))) {
+          ESP_LOGE(TAG, "Malformed feed: value in %s slot %u", we.name(), i);
+          return false;
+        }
+      }
+      if (!in.ok()) {
+        ESP_LOGE(TAG, "Feed truncated in %s", we.name());
+        return false;
+      }
+      we.times.push_back(ts);
+      ++this->fetch_stats_.slots_parsed;
+    }
+  }
+  if (record.weather_elements.empty()) {
+    ESP_LOGE(TAG, "Feed has no weather elements");
     return false;
   }
+  if (record.location_name != this->town_name_.value()) {
+    ESP_LOGW(TAG, "Feed is for %s, configured town is %s", record.location_name.c_str(),
+             this->town_name_.value().c_str());
+  }
+
+  record.index_elements();
+  record.update_time_bounds();
+  record.build_daily_summaries();
+  // Keeps the hub's fetch time, so last_updated shows the data's age
+  time_t updated = static_cast<time_t>(updated_epoch);
+  gmtime_r(&updated, &record.updated_time);
+  ESPTime now = this->rtc_->now();
+  record.timezone_offset = static_cast<double>(now.timezone_offset()) / 3600;
+
+  this->fetch_stats_.string_pool_bytes = pool.size();
+  hash_code = feed_hash;
+  ESP_LOGD(TAG, "Loaded feed: %zu elements, %" PRIu32 " slots, %zu byte string pool", record.weather_elements.size(),
+           this->fetch_stats_.slots_parsed, pool.size());
   return true;
 }
 
+#ifdef CWA_FEED_SERVER
+// Encodes the record just switched in for feed clients. Runs before the
+// record can be released after publishing, whatever retain_fetched_data says.
+void CWATownForecast::publish_feed_(uint64_t hash_code) {
+  auto feed = std::make_shared<FeedBuffer>();
+  this->record_().encode_feed(*feed, hash_code);
+  ESP_LOGD(TAG, "Serving %zu byte feed at %s", feed->size(), this->feed_handler_.get_path().c_str());
+  this->feed_handler_.publish(std::move(feed));
+}
+#endif
+
+bool CWATownForecast::retains_capacity_() {
+  return this->retain_capacity_.has_value() ? this->retain_capacity_.value() : CWA_PSRAM_AVAILABLE();
+}
+
+bool CWATownForecast::republishes_on_slot_change_() {
+  // Republishing reads the retained record, which is otherwise cleared after publishing
+  return this->republish_on_slot_change_.has_value() ? this->republish_on_slot_change_.value()
+                                                     : this->retain_fetched_data_.value();
+}
+
+void CWATownForecast::clear_record_(Record &record) {
+  if (this->retains_capacity_()) {
+    record.reset();
+  } else {
+    record.release_data();
+  }
+}
+
 // Returns the latest forecast data record.
 Record &CWATownForecast::get_data() {
   if (!this->retain_fetched_data_.value()) {
     ESP_LOGE(TAG, "Turn on retain_fetched_data option to get forecast data");
   }
-  return record_;
+  return this->record_();
 }
 
 // Checks if the data has changed based on hash code.
@@ -764,91 +1684,309 @@ bool CWATownForecast::check_changes(uint64_t new_hash_code) {
 
 // Publishes the state of the sensor or text sensor.
 template<typename SensorT, typename PublishValFunc, typename PublishNoMatchFunc>
-void CWATownForecast::publish_state_common_(SensorT *sensor, ElementValueKey key, std::tm &target_tm,
+void CWATownForecast::publish_state_common_(SensorT *sensor, ElementValueKey key, std::time_t target_epoch,
                                             bool fallback_to_first, PublishValFunc publish_val,
                                             PublishNoMatchFunc publish_no_match) {
   if (!sensor)
     return;  // Skip if sensor is null
 
-  // Find the corresponding element name for this key in the current mode
-  const char *element_name = find_mode_element_name(this->record_.mode, key);
-  if (!element_name) {
-    ESP_LOGE(TAG, "Invalid element value key for mode %s: %s", mode_to_string(this->record_.mode).c_str(),
-             element_value_key_to_string(key).c_str());
-    publish_no_match(sensor);
+#ifdef CWA_SLEEP_STATE
+  if (this->snapshot_restore_) {
+    std::string val;
+    if (!this->sleep_state_->find(static_cast<uint8_t>(key), val)) {
+      this->snapshot_missing_ = true;
+    }
+    if (!val.empty()) {
+      publish_val(sensor, val);
+    } else {
+      publish_no_match(sensor);
+    }
     return;
   }
+  // No match is kept as an empty value, so a key missing on restore means
+  // the snapshot predates the sensor
+  auto capture = [this, key](const std::string &val) {
+    if (this->snapshot_capture_)
+      this->sleep_state_->add(static_cast<uint8_t>(key), val);
+  };
+#else
+  auto capture = [](const std::string &) {};
+#endif
 
-  const WeatherElement *we = this->record_.find_weather_element(element_name);
+  // Element resolved at parse time; the slot comes from the element's cursor,
+  // which only moves forward as the RTC does
+  const WeatherElement *we = this->record_().get_weather_element_for_key(key);
   if (we && !we->times.empty()) {
-    Time *ts = we->match_time(target_tm, key, fallback_to_first);
+    Time *ts = we->current_time(target_epoch, key, fallback_to_first);
     if (ts) {
 #if ESP_LOG_LEVEL >= ESP_LOG_VERBOSE
       if (ts->data_time.is_valid()) {
-        ESP_LOGV(TAG, "matched (%s): %s", element_name,
+        ESP_LOGV(TAG, "matched (%s): %s", we->name(),
                  tm_to_esptime(ts->data_time.to_tm()).strftime("%Y-%m-%d %H:%M").c_str());
       } else if (ts->start_time_data.is_valid() && ts->end_time_data.is_valid()) {
-        ESP_LOGV(TAG, "matched (%s): %s - %s", element_name,
+        ESP_LOGV(TAG, "matched (%s): %s - %s", we->name(),
                  tm_to_esptime(ts->start_time_data.to_tm()).strftime("%Y-%m-%d %H:%M").c_str(),
                  tm_to_esptime(ts->end_time_data.to_tm()).strftime("%Y-%m-%d %H:%M").c_str());
       }
 #endif
-      auto val = ts->find_element_value(key);
+      auto val = we->find_element_value(*ts, key);
       if (!val.empty()) {
 #if ESP_LOG_LEVEL >= ESP_LOG_VERBOSE
         ESP_LOGV(TAG, "%s value: %s", element_value_key_to_string(key).c_str(), val.c_str());
 #endif
+        capture(val);
         publish_val(sensor, val);
         return;
       }
     }
-    ESP_LOGW(TAG, "No match found for %s", element_name);
+    ESP_LOGW(TAG, "No match found for %s", we->name());
+    capture("");
     publish_no_match(sensor);
   } else {
-    ESP_LOGW(TAG, "No weather element found for %s", element_name);
+    ESP_LOGW(TAG, "No weather element found for %s in mode %s", element_value_key_to_string(key).c_str(),
+             mode_to_string(this->record_().mode).c_str());
+    capture("");
     publish_no_match(sensor);
   }
 }
 
 // Publishes a numeric sensor value
-void CWATownForecast::publish_sensor_state_(sensor::Sensor *sensor, ElementValueKey key, std::tm &target_tm,
+void CWATownForecast::publish_sensor_state_(sensor::Sensor *sensor, ElementValueKey key, std::time_t target_epoch,
                                             bool fallback_to_first) {
   publish_state_common_(
-      sensor, key, target_tm, fallback_to_first,
+      sensor, key, target_epoch, fallback_to_first,
       // Lambda for publishing numeric value
-      [](sensor::Sensor *sensor, const std::string &val) {
+      [this](sensor::Sensor *sensor, const std::string &val) {
         char *endptr = nullptr;
         float fval = std::strtof(val.c_str(), &endptr);
         if (endptr != val.c_str() && *endptr == '\0') {
-          sensor->publish_state(fval);
+          this->publish_if_changed_(sensor, fval);
         } else {
           ESP_LOGW(TAG, "Invalid numeric value: %s", val.c_str());
-          sensor->publish_state(NAN);
+          this->publish_if_changed_(sensor, NAN);
         }
       },
       // Lambda for no match case
-      [](sensor::Sensor *sensor) { sensor->publish_state(NAN); });
+      [this](sensor::Sensor *sensor) { this->publish_if_changed_(sensor, NAN); });
 }
 
 // Publishes a text sensor value
 void CWATownForecast::publish_text_sensor_state_(text_sensor::TextSensor *sensor, ElementValueKey key,
-                                                 std::tm &target_tm, bool fallback_to_first) {
+                                                 std::time_t target_epoch, bool fallback_to_first) {
   publish_state_common_(
-      sensor, key, target_tm, fallback_to_first,
+      sensor, key, target_epoch, fallback_to_first,
       // Lambda for publishing text value
-      [](text_sensor::TextSensor *sensor, const std::string &val) { sensor->publish_state(val); },
+      [this](text_sensor::TextSensor *sensor, const std::string &val) { this->publish_if_changed_(sensor, val); },
       // Lambda for no match case
-      [](text_sensor::TextSensor *sensor) { sensor->publish_state(""); });
+      [this](text_sensor::TextSensor *sensor) { this->publish_if_changed_(sensor, ""); });
+}
+
+// Publishes value unless it matches the sensor's last raw state (NaN equals
+// NaN), sparing API/MQTT traffic and recorder writes for repeated values.
+// force_update sensors asked for every value, so they always publish.
+void CWATownForecast::publish_if_changed_(sensor::Sensor *sensor, float value) {
+  if (this->skip_unchanged_states_.value() && !sensor->get_force_update() && sensor->has_state()) {
+    float last = sensor->get_raw_state();
+    bool both_nan = std::isnan(last) && std::isnan(value);
+    if (both_nan || std::fabs(last - value) < UNCHANGED_STATE_EPSILON) {
+      ++this->suppressed_publishes_;
+      return;
+    }
+  }
+  sensor->publish_state(value);
+}
+
+void CWATownForecast::publish_if_changed_(text_sensor::TextSensor *sensor, const std::string &value) {
+  if (this->skip_unchanged_states_.value() && sensor->has_state() && sensor->get_raw_state() == value) {
+    ++this->suppressed_publishes_;
+    return;
+  }
+  sensor->publish_state(value);
+}
+
+// Re-publishes from the retained record when the next forecast slot begins,
+// so sensors follow the forecast between fetches without network I/O.
+void CWATownForecast::schedule_republish_() {
+  this->cancel_timeout("cwa_republish");
+  if (!this->republishes_on_slot_change_() || this->record_().weather_elements.empty()) {
+    return;
+  }
+  ESPTime now = this->rtc_->now();
+  if (!now.is_valid()) {
+    return;
+  }
+  std::time_t now_epoch = TimeField::to_wall_epoch(now.to_c_tm());
+  std::time_t next_epoch = this->record_().next_slot_boundary(now_epoch);
+  if (next_epoch == 0) {
+    ESP_LOGD(TAG, "No forecast slot boundary ahead, republish not scheduled");
+    return;
+  }
+  // Fire just past the boundary so the new slot is already current
+  uint32_t delay_ms = static_cast<uint32_t>(next_epoch - now_epoch) * 1000 + 500;
+  ESP_LOGD(TAG, "Republishing at next slot boundary in %" PRIu32 " s", delay_ms / 1000);
+  this->set_timeout("cwa_republish", delay_ms, [this]() {
+    // Early data clear may have dropped the record for a fetch in progress;
+    // that fetch publishes and reschedules on its own
+    if (this->record_().weather_elements.empty())
+      return;
+    ESP_LOGD(TAG, "Forecast slot changed, republishing retained data");
+    this->publish_states_();
+    this->schedule_republish_();
+  });
+}
+
+// Waits for the clock and network, then makes the first prefetch fetch; the
+// ones after are scheduled as each fetch completes.
+void CWATownForecast::start_prefetch_() {
+  bool wait = !this->rtc_->now().is_valid();
+  if (!wait && this->get_source()->needs_network() && !network::is_connected()) {
+    wait = true;
+#ifdef CWA_SLEEP_STATE
+    // Serving the snapshot needs no network
+    wait = this->sleep_state_ == nullptr || this->fetch_needed_();
+#endif
+  }
+  if (wait) {
+    this->set_timeout("cwa_prefetch", 5000, [this]() { this->start_prefetch_(); });
+    return;
+  }
+  this->update();
+}
+
+// Schedules the next fetch shortly after CWA is expected to serve the next
+// issue, or a recheck while an issue is overdue (see PublicationSchedule).
+// first_slot is the fetched record's first slot in UTC, 0 after a failure.
+// Any fetch, also one from update_interval or an automation, reschedules.
+void CWATownForecast::schedule_prefetch_(time_t first_slot) {
+  if (!this->prefetch_) {
+    return;
+  }
+  ESPTime now = this->rtc_->now();
+  if (!now.is_valid()) {
+    this->start_prefetch_();
+    return;
+  }
+  uint32_t delay_s = this->schedule_.on_fetch(now.timestamp, first_slot, esp_random());
+  ESP_LOGD(TAG, "Next fetch in %" PRIu32 " s (issue %s, lag %" PRIu32 " s, %" PRIu32 " rechecks)", delay_s,
+           ESPTime::from_epoch_local(this->schedule_.get_held_issue()).strftime("%m-%d %H:%M").c_str(),
+           this->schedule_.get_lag(), this->schedule_.get_misses());
+  this->set_timeout("cwa_prefetch", delay_s * 1000, [this]() { this->update(); });
+}
+
+#ifdef CWA_SLEEP_STATE
+void CWATownForecast::set_sleep_state_slot(uint8_t slot) { this->sleep_state_ = &sleep_states[slot]; }
+
+// Identifies what the kept state belongs to; a state saved for another
+// town, mode or layout is discarded
+uint32_t CWATownForecast::query_hash_() {
+  const std::string city = this->city_name_.value();
+  const std::string town = this->town_name_.value();
+  const uint32_t layout[] = {static_cast<uint32_t>(this->mode_), static_cast<uint32_t>(sizeof(SleepState))};
+  uint32_t hash = SleepState::fnv1a(city.c_str(), city.size() + 1);
+  hash = SleepState::fnv1a(town.c_str(), town.size() + 1, hash);
+  return SleepState::fnv1a(layout, sizeof(layout), hash);
 }
 
+// Picks up the state kept across deep sleep and, while its snapshot covers
+// now, publishes it at once, before the network is up
+void CWATownForecast::restore_sleep_state_() {
+  SleepState &state = *this->sleep_state_;
+  const uint32_t query = this->query_hash_();
+  if (!state.is_valid(query)) {
+    ESP_LOGD(TAG, "No sleep state kept, starting fresh");
+    state.reset(query);
+    state.commit();
+    return;
+  }
+  this->last_hash_code_ = state.hash_code;
+  this->schedule_.restore(state.held_issue, state.lag, state.misses);
+  ESPTime now = this->rtc_->now();
+  if (!now.is_valid() || !state.covers(now.timestamp)) {
+    ESP_LOGD(TAG, "Sleep state kept, snapshot expired");
+    return;
+  }
+  ESP_LOGD(TAG, "Sleep state kept, publishing snapshot fetched %" PRId64 " s ago",
+           static_cast<int64_t>(now.timestamp - state.fetched_at));
+  this->publish_snapshot_();
+}
+
+// Saves what the next wake needs. After a fetch that is the record's hash,
+// ETag, first slot and the end of the current slot, besides the snapshot
+// publish_states_() captured; otherwise only the schedule.
+void CWATownForecast::save_sleep_state_(bool fetched) {
+  SleepState &state = *this->sleep_state_;
+  if (fetched) {
+    const Record &record = this->record_();
+    ESPTime now = this->rtc_->now();
+    std::time_t now_wall = TimeField::to_wall_epoch(now.to_c_tm());
+    std::time_t boundary = record.next_slot_boundary(now_wall);
+    state.hash_code = this->last_hash_code_;
+    state.fetched_at = now.timestamp;
+    // Slot times compare against the device's wall clock, like publishing does
+    state.valid_until = boundary != 0 ? boundary - (now_wall - now.timestamp) : 0;
+    state.first_slot = TimeField::to_wall_epoch(record.start_time) - PublicationSchedule::CWA_UTC_OFFSET;
+    state.set_etag(this->get_source()->get_etag());
+    state.add(SleepState::KEY_LOCATIONS_NAME, record.locations_name);
+    state.add(SleepState::KEY_LOCATION_NAME, record.location_name);
+    ESP_LOGD(TAG, "Sleep state: %u snapshot bytes%s, valid for %" PRId64 " s%s", state.snapshot_used,
+             state.snapshot_complete ? "" : " (incomplete)", static_cast<int64_t>(state.valid_until - now.timestamp),
+             state.etag[0] != '\0' ? ", ETag kept" : "");
+  }
+  state.held_issue = this->schedule_.get_held_issue();
+  state.lag = this->schedule_.get_lag();
+  state.misses = this->schedule_.get_misses();
+  state.commit();
+}
+
+// Whether update() has to fetch, or the snapshot still serves: it must cover
+// now, and with prefetch no new issue may be due, otherwise update_interval
+// must not have passed since the fetch
+bool CWATownForecast::fetch_needed_() {
+  const SleepState &state = *this->sleep_state_;
+  ESPTime now = this->rtc_->now();
+  if (!now.is_valid() || !state.covers(now.timestamp)) {
+    return true;
+  }
+  if (this->prefetch_) {
+    return now.timestamp >= this->schedule_.next_due();
+  }
+  const uint32_t interval = this->get_update_interval();
+  return interval != SCHEDULER_DONT_RUN && now.timestamp - state.fetched_at >= static_cast<time_t>(interval / 1000);
+}
+
+// Publishes the snapshot through the usual publish pass. Returns false, and
+// drops the snapshot, when a sensor had no value kept, e.g. one added since.
+bool CWATownForecast::publish_snapshot_() {
+  this->snapshot_missing_ = false;
+  this->snapshot_restore_ = true;
+  this->publish_states_();
+  this->snapshot_restore_ = false;
+  if (this->snapshot_missing_) {
+    ESP_LOGD(TAG, "Snapshot lacks configured sensors, next update fetches");
+    this->sleep_state_->snapshot_complete = false;
+    this->sleep_state_->commit();
+    return false;
+  }
+  return true;
+}
+#endif
+
 // Publishes all weather states to sensors/text sensors.
 void CWATownForecast::publish_states_() {
   // Publish diagnostic sensors: city and town names
+  std::string locations_name = this->record_().locations_name;
+  std::string location_name = this->record_().location_name;
+#ifdef CWA_SLEEP_STATE
+  if (this->snapshot_restore_) {
+    this->sleep_state_->find(SleepState::KEY_LOCATIONS_NAME, locations_name);
+    this->sleep_state_->find(SleepState::KEY_LOCATION_NAME, location_name);
+  }
+#endif
   if (this->city_sensor_) {
-    this->city_sensor_->publish_state(record_.locations_name);
+    this->publish_if_changed_(this->city_sensor_, locations_name);
   }
   if (this->town_sensor_) {
-    this->town_sensor_->publish_state(record_.location_name);
+    this->publish_if_changed_(this->town_sensor_, location_name);
   }
 
   // Get current time for time-based data
@@ -866,7 +2004,8 @@ void CWATownForecast::publish_states_() {
     this->last_updated_->publish_state(now_str);
   }
 
-  std::tm target_tm = now.to_c_tm();
+  uint32_t publish_start = millis();
+  std::time_t target_epoch = TimeField::to_wall_epoch(now.to_c_tm());
   // Get the fallback flag for missing data
   bool fallback = this->fallback_to_first_element_.value();
 
@@ -874,87 +2013,101 @@ void CWATownForecast::publish_states_() {
   if (mode_ == Mode::THREE_DAYS) {
     // 3-day mode sensors
     if (this->temperature_)
-      publish_sensor_state_(this->temperature_, ElementValueKey::TEMPERATURE, target_tm, fallback);
+      publish_sensor_state_(this->temperature_, ElementValueKey::TEMPERATURE, target_epoch, fallback);
     if (this->dew_point_)
-      publish_sensor_state_(this->dew_point_, ElementValueKey::DEW_POINT, target_tm, fallback);
+      publish_sensor_state_(this->dew_point_, ElementValueKey::DEW_POINT, target_epoch, fallback);
     if (this->apparent_temperature_)
-      publish_sensor_state_(this->apparent_temperature_, ElementValueKey::APPARENT_TEMPERATURE, target_tm, fallback);
+      publish_sensor_state_(this->apparent_temperature_, ElementValueKey::APPARENT_TEMPERATURE, target_epoch, fallback);
     if (this->comfort_index_)
-      publish_text_sensor_state_(this->comfort_index_, ElementValueKey::COMFORT_INDEX, target_tm, fallback);
+      publish_text_sensor_state_(this->comfort_index_, ElementValueKey::COMFORT_INDEX, target_epoch, fallback);
     if (this->comfort_index_description_)
       publish_text_sensor_state_(this->comfort_index_description_, ElementValueKey::COMFORT_INDEX_DESCRIPTION,
-                                 target_tm, fallback);
+                                 target_epoch, fallback);
     if (this->relative_humidity_)
-      publish_sensor_state_(this->relative_humidity_, ElementValueKey::RELATIVE_HUMIDITY, target_tm, fallback);
+      publish_sensor_state_(this->relative_humidity_, ElementValueKey::RELATIVE_HUMIDITY, target_epoch, fallback);
     if (this->wind_speed_)
-      publish_sensor_state_(this->wind_speed_, ElementValueKey::WIND_SPEED, target_tm, fallback);
+      publish_sensor_state_(this->wind_speed_, ElementValueKey::WIND_SPEED, target_epoch, fallback);
     if (this->probability_of_precipitation_)
       publish_sensor_state_(this->probability_of_precipitation_, ElementValueKey::PROBABILITY_OF_PRECIPITATION,
-                            target_tm, fallback);
+                            target_epoch, fallback);
     if (this->weather_)
-      publish_text_sensor_state_(this->weather_, ElementValueKey::WEATHER, target_tm, fallback);
+      publish_text_sensor_state_(this->weather_, ElementValueKey::WEATHER, target_epoch, fallback);
     if (this->weather_code_)
-      publish_text_sensor_state_(this->weather_code_, ElementValueKey::WEATHER_CODE, target_tm, fallback);
+      publish_text_sensor_state_(this->weather_code_, ElementValueKey::WEATHER_CODE, target_epoch, fallback);
     if (this->weather_description_)
-      publish_text_sensor_state_(this->weather_description_, ElementValueKey::WEATHER_DESCRIPTION, target_tm, fallback);
+      publish_text_sensor_state_(this->weather_description_, ElementValueKey::WEATHER_DESCRIPTION, target_epoch,
+                                 fallback);
     if (this->weather_icon_)
-      publish_text_sensor_state_(this->weather_icon_, ElementValueKey::WEATHER_ICON, target_tm, fallback);
+      publish_text_sensor_state_(this->weather_icon_, ElementValueKey::WEATHER_ICON, target_epoch, fallback);
     if (this->wind_direction_)
-      publish_text_sensor_state_(this->wind_direction_, ElementValueKey::WIND_DIRECTION, target_tm, fallback);
+      publish_text_sensor_state_(this->wind_direction_, ElementValueKey::WIND_DIRECTION, target_epoch, fallback);
     if (this->beaufort_scale_)
-      publish_text_sensor_state_(this->beaufort_scale_, ElementValueKey::BEAUFORT_SCALE, target_tm, fallback);
+      publish_text_sensor_state_(this->beaufort_scale_, ElementValueKey::BEAUFORT_SCALE, target_epoch, fallback);
   } else if (mode_ == Mode::SEVEN_DAYS) {
     // 7-day mode sensors
     if (this->temperature_)
-      publish_sensor_state_(this->temperature_, ElementValueKey::TEMPERATURE, target_tm, fallback);
+      publish_sensor_state_(this->temperature_, ElementValueKey::TEMPERATURE, target_epoch, fallback);
     if (this->dew_point_)
-      publish_sensor_state_(this->dew_point_, ElementValueKey::DEW_POINT, target_tm, fallback);
+      publish_sensor_state_(this->dew_point_, ElementValueKey::DEW_POINT, target_epoch, fallback);
     if (this->relative_humidity_)
-      publish_sensor_state_(this->relative_humidity_, ElementValueKey::RELATIVE_HUMIDITY, target_tm, fallback);
+      publish_sensor_state_(this->relative_humidity_, ElementValueKey::RELATIVE_HUMIDITY, target_epoch, fallback);
     if (this->wind_speed_)
-      publish_sensor_state_(this->wind_speed_, ElementValueKey::WIND_SPEED, target_tm, fallback);
+      publish_sensor_state_(this->wind_speed_, ElementValueKey::WIND_SPEED, target_epoch, fallback);
     if (this->beaufort_scale_)
-      publish_text_sensor_state_(this->beaufort_scale_, ElementValueKey::BEAUFORT_SCALE, target_tm, fallback);
+      publish_text_sensor_state_(this->beaufort_scale_, ElementValueKey::BEAUFORT_SCALE, target_epoch, fallback);
     if (this->probability_of_precipitation_)
       publish_sensor_state_(this->probability_of_precipitation_, ElementValueKey::PROBABILITY_OF_PRECIPITATION,
-                            target_tm, fallback);
+                            target_epoch, fallback);
     if (this->max_temperature_)
-      publish_sensor_state_(this->max_temperature_, ElementValueKey::MAX_TEMPERATURE, target_tm, fallback);
+      publish_sensor_state_(this->max_temperature_, ElementValueKey::MAX_TEMPERATURE, target_epoch, fallback);
     if (this->min_temperature_)
-      publish_sensor_state_(this->min_temperature_, ElementValueKey::MIN_TEMPERATURE, target_tm, fallback);
+      publish_sensor_state_(this->min_temperature_, ElementValueKey::MIN_TEMPERATURE, target_epoch, fallback);
     if (this->max_apparent_temperature_)
-      publish_sensor_state_(this->max_apparent_temperature_, ElementValueKey::MAX_APPARENT_TEMPERATURE, target_tm,
+      publish_sensor_state_(this->max_apparent_temperature_, ElementValueKey::MAX_APPARENT_TEMPERATURE, target_epoch,
                             fallback);
     if (this->min_apparent_temperature_)
-      publish_sensor_state_(this->min_apparent_temperature_, ElementValueKey::MIN_APPARENT_TEMPERATURE, target_tm,
+      publish_sensor_state_(this->min_apparent_temperature_, ElementValueKey::MIN_APPARENT_TEMPERATURE, target_epoch,
                             fallback);
     if (this->max_comfort_index_)
-      publish_text_sensor_state_(this->max_comfort_index_, ElementValueKey::MAX_COMFORT_INDEX, target_tm, fallback);
+      publish_text_sensor_state_(this->max_comfort_index_, ElementValueKey::MAX_COMFORT_INDEX, target_epoch, fallback);
     if (this->min_comfort_index_)
-      publish_text_sensor_state_(this->min_comfort_index_, ElementValueKey::MIN_COMFORT_INDEX, target_tm, fallback);
+      publish_text_sensor_state_(this->min_comfort_index_, ElementValueKey::MIN_COMFORT_INDEX, target_epoch, fallback);
     if (this->max_comfort_index_description_)
       publish_text_sensor_state_(this->max_comfort_index_description_, ElementValueKey::MAX_COMFORT_INDEX_DESCRIPTION,
-                                 target_tm, fallback);
+                                 target_epoch, fallback);
     if (this->min_comfort_index_description_)
       publish_text_sensor_state_(this->min_comfort_index_description_, ElementValueKey::MIN_COMFORT_INDEX_DESCRIPTION,
-                                 target_tm, fallback);
+                                 target_epoch, fallback);
     if (this->uv_index_)
-      publish_sensor_state_(this->uv_index_, ElementValueKey::UV_INDEX, target_tm, fallback);
+      publish_sensor_state_(this->uv_index_, ElementValueKey::UV_INDEX, target_epoch, fallback);
     if (this->uv_exposure_level_)
-      publish_text_sensor_state_(this->uv_exposure_level_, ElementValueKey::UV_EXPOSURE_LEVEL, target_tm, fallback);
+      publish_text_sensor_state_(this->uv_exposure_level_, ElementValueKey::UV_EXPOSURE_LEVEL, target_epoch, fallback);
     if (this->weather_)
-      publish_text_sensor_state_(this->weather_, ElementValueKey::WEATHER, target_tm, fallback);
+      publish_text_sensor_state_(this->weather_, ElementValueKey::WEATHER, target_epoch, fallback);
     if (this->weather_code_)
-      publish_text_sensor_state_(this->weather_code_, ElementValueKey::WEATHER_CODE, target_tm, fallback);
+      publish_text_sensor_state_(this->weather_code_, ElementValueKey::WEATHER_CODE, target_epoch, fallback);
     if (this->weather_icon_)
-      publish_text_sensor_state_(this->weather_icon_, ElementValueKey::WEATHER_ICON, target_tm, fallback);
+      publish_text_sensor_state_(this->weather_icon_, ElementValueKey::WEATHER_ICON, target_epoch, fallback);
     if (this->weather_description_)
-      publish_text_sensor_state_(this->weather_description_, ElementValueKey::WEATHER_DESCRIPTION, target_tm, fallback);
+      publish_text_sensor_state_(this->weather_description_, ElementValueKey::WEATHER_DESCRIPTION, target_epoch,
+                                 fallback);
     if (this->wind_direction_)
-      publish_text_sensor_state_(this->wind_direction_, ElementValueKey::WIND_DIRECTION, target_tm, fallback);
+      publish_text_sensor_state_(this->wind_direction_, ElementValueKey::WIND_DIRECTION, target_epoch, fallback);
   } else {
     ESP_LOGE(TAG, "Invalid mode in publish_states_: %s", mode_to_string(mode_).c_str());
   }
+  ESP_LOGD(TAG, "Unchanged states skipped so far: %" PRIu32, this->suppressed_publishes_);
+
+  this->fetch_stats_.publish_ms = millis() - publish_start;
+  if (this->publish_time_)
+    this->publish_time_->publish_state(this->fetch_stats_.publish_ms);
+  // millis() restarts on every boot, deep sleep wake included
+  if (!this->wake_reported_) {
+    this->wake_reported_ = true;
+    ESP_LOGD(TAG, "First publish %" PRIu32 " ms after wake", millis());
+    if (this->wake_to_publish_time_)
+      this->wake_to_publish_time_->publish_state(millis());
+  }
 }
 
 }  // namespace cwa_town_forecast
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <cstring>
 #include <ctime>
@@ -27,7 +29,11 @@
 
 #include "esphome/components/http_request/http_request.h"
 #include "forecast_constants.h"
+#include "forecast_feed.h"
+#include "forecast_source.h"
 #include "psram_allocator.h"
+#include "publication_schedule.h"
+#include "sleep_state.h"
 #include "string_pool.h"
 #include "time_field.h"
 #include "http_stream_adapter.h"
@@ -44,7 +50,26 @@ namespace cwa_town_forecast {
 
 static constexpr const char *const TAG = "cwa_town_forecast";
 
+struct Time;
+struct WeatherElement;
+template<> struct AllocCategoryOf<Time> {
+  static constexpr AllocCategory value = AllocCategory::TIMES;
+};
+template<> struct AllocCategoryOf<WeatherElement> {
+  static constexpr AllocCategory value = AllocCategory::ELEMENTS;
+};
+
 static constexpr int UV_LOOKAHEAD_MINUTES = 90;
+static constexpr const char *DEFAULT_BASE_URL = "https://opendata.cwa.gov.tw/api/v1/rest/datastore/";
+// timeTo requested when it is derived from sensors that only read the current
+// slot: one 3-day slot plus the UV lookahead, or one 7-day day/night pair
+static constexpr uint32_t AUTO_TIME_TO_HOURS_3DAYS = 6;
+static constexpr uint32_t AUTO_TIME_TO_HOURS_7DAYS = 24;
+// Upper bound on one serialized time slot (CWA's largest are ~300 bytes); a
+// bigger one aborts the parse instead of growing the slot document
+static constexpr size_t MAX_SLOT_BYTES = 4096;
+// Numeric states closer than this to the last published one are not re-sent
+static constexpr float UNCHANGED_STATE_EPSILON = 0.001f;
 
 enum EarlyDataClear {
   AUTO,
@@ -92,11 +117,11 @@ static inline ESPTime tm_to_esptime(const std::tm tm) {
   return esp_time;
 }
 
-// One element value: the key plus a 16-bit offset into the record's
-// StringPool where the value text lives.
+// One element value: the key plus an offset into the record's StringPool
+// where the value text lives.
 struct ElementValueEntry {
-  uint8_t key;      // ElementValueKey
-  uint16_t offset;  // into the owning Record's StringPool
+  uint8_t key;              // ElementValueKey
+  StringPoolOffset offset;  // into the owning Record's StringPool
 };
 
 // Fixed-capacity inline storage for a time slot's element values. Real CWA
@@ -117,7 +142,7 @@ class ElementValueArray {
   size_t size() const { return count_; }
   bool empty() const { return count_ == 0; }
 
-  bool emplace_back(ElementValueKey key, uint16_t offset) {
+  bool emplace_back(ElementValueKey key, StringPoolOffset offset) {
     if (count_ >= CAPACITY)
       return false;
     items_[count_].key = static_cast<uint8_t>(key);
@@ -137,20 +162,37 @@ struct Time {
   TimeField data_time;
   TimeField start_time_data;
   TimeField end_time_data;
+  // Offsets into the owning Record's string pool; resolve them through
+  // Record::find_element_value(), WeatherElement::find_element_value() or a
+  // TimeSnapshot.
   ElementValueArray element_values;
-  // Resolves element_values offsets. Shared ownership: a Time copied out of
-  // the Record (e.g. a filter_times() result) keeps the pool alive on its
-  // own, so stale copies read their original values instead of dangling.
-  std::shared_ptr<const StringPool> string_pool;
 
-  std::string find_element_value(ElementValueKey key) const {
+  std::string find_element_value(ElementValueKey key, const StringPool *pool) const {
     for (const auto &p : this->element_values) {
       if (p.key == static_cast<uint8_t>(key))
-        return this->string_pool ? std::string(this->string_pool->get(p.offset)) : std::string();
+        return pool ? std::string(pool->get(p.offset)) : std::string();
     }
     return std::string();
   }
 
+  // Parses key's value as a number; false when absent or not fully numeric.
+  bool find_numeric_value(ElementValueKey key, const StringPool *pool, float &out) const {
+    for (const auto &p : this->element_values) {
+      if (p.key != static_cast<uint8_t>(key))
+        continue;
+      if (!pool)
+        return false;
+      const char *str = pool->get(p.offset);
+      char *endptr = nullptr;
+      float num = std::strtof(str, &endptr);
+      if (endptr == str || *endptr != '\0')
+        return false;
+      out = num;
+      return true;
+    }
+    return false;
+  }
+
   // The field that represents this slot: instantaneous DataTime when present,
   // otherwise the interval's StartTime (possibly invalid when neither is set)
   const TimeField &primary_field() const {
@@ -169,15 +211,61 @@ struct Time {
   ESPTime to_esptime() const { return tm_to_esptime(this->to_tm()); }
 };
 
-// Utility function to get min and max value for a given ElementValueKey in a vector of Time
-template<typename Alloc>
-inline std::pair<double, double> get_min_max_element_value(const std::vector<Time, Alloc> &times, ElementValueKey key) {
+// A Time detached from its Record: holds its own reference to the string
+// pool so it stays readable after the Record is re-parsed or released. Only
+// WeatherElement::filter_times() creates these; everything else uses plain
+// Times resolved through the Record.
+struct TimeSnapshot : Time {
+  std::shared_ptr<const StringPool> string_pool;
+
+  TimeSnapshot() = default;
+  TimeSnapshot(const Time &t, std::shared_ptr<const StringPool> pool) : Time(t), string_pool(std::move(pool)) {}
+
+  using Time::find_element_value;
+  using Time::find_numeric_value;
+  std::string find_element_value(ElementValueKey key) const {
+    return Time::find_element_value(key, this->string_pool.get());
+  }
+  bool find_numeric_value(ElementValueKey key, float &out) const {
+    return Time::find_numeric_value(key, this->string_pool.get(), out);
+  }
+};
+
+// Non-owning view over a contiguous run of a WeatherElement's times, as
+// returned by WeatherElement::range(). Iterating it allocates nothing.
+// Invalidated when the owning Record is released or re-parsed.
+class TimeRange {
+ public:
+  using value_type = Time;
+  using const_iterator = const Time *;
+
+  TimeRange() = default;
+  TimeRange(const Time *first, const Time *last) : first_(first), last_(last) {}
+
+  const Time *begin() const { return this->first_; }
+  const Time *end() const { return this->last_; }
+  size_t size() const { return static_cast<size_t>(this->last_ - this->first_); }
+  bool empty() const { return this->first_ == this->last_; }
+  const Time &operator[](size_t i) const { return this->first_[i]; }
+  const Time &front() const { return *this->first_; }
+  const Time &back() const { return *(this->last_ - 1); }
+
+ private:
+  const Time *first_{nullptr};
+  const Time *last_{nullptr};
+};
+
+// Utility function to get min and max value for a given ElementValueKey in a
+// sequence of Time (a vector or a TimeRange) whose values live in pool
+template<typename Range>
+inline std::pair<double, double> get_min_max_element_value(const Range &times, ElementValueKey key,
+                                                           const StringPool *pool) {
   using std::begin;
   using std::end;
   double min_val = 0.0, max_val = 0.0;
   bool found = false;
   for (const auto &t : times) {
-    std::string val = t.find_element_value(key);
+    std::string val = t.find_element_value(key, pool);
     if (!val.empty()) {
       char *endptr = nullptr;
       double num = std::strtod(val.c_str(), &endptr);
@@ -199,27 +287,54 @@ inline std::pair<double, double> get_min_max_element_value(const std::vector<Tim
 }
 
 struct WeatherElement {
-  std::string element_name;
+  WeatherElementId id{WeatherElementId::UNKNOWN};
+
+  // ElementName as published by CWA (flash-resident, not stored per element).
+  const char *name() const { return weather_element_name(this->id); }
   std::vector<Time, PsramAllocator<Time>> times;
+  // The owning Record's pool, shared once per element rather than per slot
+  std::shared_ptr<const StringPool> string_pool;
+
+  std::string find_element_value(const Time &t, ElementValueKey key) const {
+    return t.find_element_value(key, this->string_pool.get());
+  }
+  bool find_numeric_value(const Time &t, ElementValueKey key, float &out) const {
+    return t.find_numeric_value(key, this->string_pool.get(), out);
+  }
 
-  std::vector<Time, PsramAllocator<Time>> filter_times(const std::tm &start, const std::tm &end) const {
-    std::vector<Time, PsramAllocator<Time>> result;
+  // Slots inside [start, end): DataTime points within it, or intervals
+  // overlapping it. CWA lists slots in chronological order, so the matches
+  // are contiguous and found by binary search without copying.
+  TimeRange range(const std::tm &start, const std::tm &end) const {
     std::time_t start_epoch = TimeField::to_wall_epoch(start);
     std::time_t end_epoch = TimeField::to_wall_epoch(end);
-    for (const auto &t : this->times) {
-      if (t.data_time) {
-        std::time_t dt_epoch = t.data_time.epoch();
-        if (dt_epoch >= start_epoch && dt_epoch < end_epoch) {
-          result.push_back(t);
-        }
-      } else if (t.start_time_data.is_valid() && t.end_time_data.is_valid()) {
-        // check if interval overlaps [start, end)
-        if (t.end_time_data.epoch() > start_epoch && t.start_time_data.epoch() < end_epoch) {
-          result.push_back(t);
-        }
-      }
-    }
-    return result;
+    const Time *first = this->times.data();
+    const Time *last = first + this->times.size();
+    // Slots entirely before start
+    first = std::partition_point(first, last, [start_epoch](const Time &t) {
+      if (t.data_time)
+        return t.data_time.epoch() < start_epoch;
+      return t.end_time_data.is_valid() && t.end_time_data.epoch() <= start_epoch;
+    });
+    // Slots beginning before end
+    last = std::partition_point(first, last, [end_epoch](const Time &t) {
+      if (t.data_time)
+        return t.data_time.epoch() < end_epoch;
+      return t.start_time_data.is_valid() && t.start_time_data.epoch() < end_epoch;
+    });
+    return TimeRange(first, last);
+  }
+
+  // Owning copy of range(start, end); prefer range() unless the slots must
+  // outlive the Record.
+  std::vector<TimeSnapshot, PsramAllocator<TimeSnapshot>> filter_times(const std::tm &start,
+                                                                      const std::tm &end) const {
+    TimeRange r = this->range(start, end);
+    std::vector<TimeSnapshot, PsramAllocator<TimeSnapshot>> out;
+    out.reserve(r.size());
+    for (const auto &t : r)
+      out.emplace_back(t, this->string_pool);
+    return out;
   }
 
   Time *find_closest_time(const std::tm &target) const {
@@ -257,22 +372,100 @@ struct WeatherElement {
         }
       }
     }
-    if (best == nullptr && fallback_to_first_element) {
-      best = const_cast<Time *>(&this->times[0]);
-      if (key == ElementValueKey::UV_EXPOSURE_LEVEL || key == ElementValueKey::UV_INDEX) {
-        if (best->start_time_data.is_valid()) {
-          std::time_t st_epoch = best->start_time_data.epoch();
-          if (st_epoch > tgt_epoch && (st_epoch - tgt_epoch) > UV_LOOKAHEAD_MINUTES * 60) {
-            ESP_LOGW(TAG, "UV data fallback outside of the forecast window");
-            return nullptr;
-          }
+    if (best == nullptr && fallback_to_first_element)
+      return this->fallback_time_(tgt_epoch, key);
+    return best;
+  }
+
+  // Same result as match_time() for a wall epoch, but resumes from the slot
+  // found by the previous call instead of scanning from the start. Targets
+  // normally follow the RTC forward, so repeated publishes cost O(1)
+  // amortized; a target earlier than the previous one, or a cursor past a
+  // shrunken times, restarts the scan. Relies on the chronological slot order
+  // CWA guarantees; code removing slots from times must call reset_cursor().
+  Time *current_time(std::time_t tgt_epoch, ElementValueKey key, bool fallback_to_first_element) const {
+    const size_t n = this->times.size();
+    if (n == 0)
+      return nullptr;
+    if (tgt_epoch < this->cursor_epoch_ || this->cursor_ >= n)
+      this->cursor_ = 0;
+    this->cursor_epoch_ = tgt_epoch;
+
+    const Time *found = nullptr;
+    if (this->times[0].data_time) {
+      // Latest point at or before the target
+      while (this->cursor_ + 1 < n && this->times[this->cursor_ + 1].data_time.epoch() <= tgt_epoch)
+        ++this->cursor_;
+      if (this->times[this->cursor_].data_time.epoch() <= tgt_epoch)
+        found = &this->times[this->cursor_];
+    } else {
+      // First interval not yet over; a match when it has started
+      while (this->cursor_ < n && this->times[this->cursor_].end_time_data.epoch() <= tgt_epoch)
+        ++this->cursor_;
+      if (this->cursor_ < n && this->times[this->cursor_].start_time_data.epoch() <= tgt_epoch)
+        found = &this->times[this->cursor_];
+    }
+    if (found != nullptr)
+      return const_cast<Time *>(found);
+    return fallback_to_first_element ? this->fallback_time_(tgt_epoch, key) : nullptr;
+  }
+
+  // Samples key on the grid start + i * step_seconds (i < count) into out.
+  // DataTime series interpolate between points (LINEAR) or hold the latest
+  // point until the next one (STEP); interval series interpolate between
+  // interval midpoints (LINEAR) or take the covering interval (STEP). Grid
+  // points outside the data, or next to non-numeric values, are NaN.
+  // Returns the number of non-NaN samples written.
+  size_t resample(ElementValueKey key, const std::tm &start, uint32_t step_seconds, float *out, size_t count,
+                  ResampleMethod method) const;
+
+  // Empties the element for refilling; times keeps its capacity.
+  void clear() {
+    this->id = WeatherElementId::UNKNOWN;
+    this->times.clear();
+    this->string_pool.reset();
+    this->reset_cursor();
+  }
+
+  // Restarts current_time() from the first slot, as slot indices shift
+  void reset_cursor() const {
+    this->cursor_ = 0;
+    this->cursor_epoch_ = std::numeric_limits<std::time_t>::min();
+  }
+
+ protected:
+  // First slot as a stand-in when nothing matches, except for UV data that
+  // starts too far ahead to be meaningful now.
+  Time *fallback_time_(std::time_t tgt_epoch, ElementValueKey key) const {
+    Time *best = const_cast<Time *>(&this->times[0]);
+    if (key == ElementValueKey::UV_EXPOSURE_LEVEL || key == ElementValueKey::UV_INDEX) {
+      if (best->start_time_data.is_valid()) {
+        std::time_t st_epoch = best->start_time_data.epoch();
+        if (st_epoch > tgt_epoch && (st_epoch - tgt_epoch) > UV_LOOKAHEAD_MINUTES * 60) {
+          ESP_LOGW(TAG, "UV data fallback outside of the forecast window");
+          return nullptr;
         }
       }
-      ESP_LOGW(TAG, "No matching time found for %s, using first element :%s", this->element_name.c_str(),
-               best->to_esptime().strftime("%Y-%m-%d %H:%M").c_str());
     }
+    ESP_LOGW(TAG, "No matching time found for %s, using first element :%s", this->name(),
+             best->to_esptime().strftime("%Y-%m-%d %H:%M").c_str());
     return best;
   }
+
+  // current_time() position; cursor_epoch_ detects targets moving backwards
+  mutable size_t cursor_{0};
+  mutable std::time_t cursor_epoch_{std::numeric_limits<std::time_t>::min()};
+};
+
+// Min/max/mean of one numeric element value key over one calendar day, built
+// once per parse (see Record::daily_summary()). All fields are NaN when the
+// day has no data for the key.
+struct DailySummary {
+  float min;
+  float max;
+  float mean;
+
+  bool valid() const { return !std::isnan(this->mean); }
 };
 
 // Result of Record::find_weather_icon(): everything a display lambda needs to
@@ -302,11 +495,27 @@ struct Record {
   // Hours east of UTC, captured from the RTC when the record was parsed; used
   // for sunrise/sunset calculation. CWA data is Taiwan-only, hence the default.
   double timezone_offset{8.0};
+  // Bumped whenever the slot data changes (each parse, prune_before()), so
+  // derived caches such as SeriesCache know when to recompute.
+  uint32_t generation{0};
+  // weather_elements index + 1 per WeatherElementId (0 = element absent),
+  // filled by index_elements() after parsing.
+  uint8_t element_slot[WEATHER_ELEMENT_ID_COUNT]{};
   std::vector<WeatherElement, PsramAllocator<WeatherElement>> weather_elements;
+  // Per-day aggregates: rows are calendar days counted from the date of
+  // start_time (summary_base_epoch is 00:00 of that day), columns are
+  // numeric_key_index(); daily_summary_valid holds one bit per column.
+  static constexpr size_t MAX_SUMMARY_DAYS = 8;
+  time_t summary_base_epoch{0};
+  DailySummary daily_summaries[MAX_SUMMARY_DAYS][NUMERIC_ELEMENT_VALUE_KEY_COUNT]{};
+  uint16_t daily_summary_valid[MAX_SUMMARY_DAYS]{};
   // Deduplicated value storage referenced by every Time's element_values.
-  // Shared with the Times so the pool outlives any Time copied out of this
-  // Record; heap address stays stable across Record moves.
+  // Shared with the elements and any TimeSnapshot so the pool outlives copies
+  // taken out of this Record; heap address stays stable across Record moves.
   std::shared_ptr<StringPool> string_pool;
+  // Emptied elements parked by reset(), with their times capacity, for
+  // add_element() to hand out again; freed by trim() and release_data().
+  std::vector<WeatherElement, PsramAllocator<WeatherElement>> spare_elements;
 
   // Note: Using standard types provides full compatibility while the internal
   // Time and WeatherElement structures use adaptive memory allocation for optimization
@@ -318,22 +527,167 @@ struct Record {
       std::vector<WeatherElement, PsramAllocator<WeatherElement>> empty(weather_elements.get_allocator());
       weather_elements.swap(empty);
     }  // empty destroyed here, all backing stores freed
+    {
+      std::vector<WeatherElement, PsramAllocator<WeatherElement>> empty(spare_elements.get_allocator());
+      spare_elements.swap(empty);
+    }
     string_pool.reset();
+    memset(this->daily_summary_valid, 0, sizeof(this->daily_summary_valid));
+    memset(this->element_slot, 0, sizeof(this->element_slot));
+    ++this->generation;
   }
 
-  const WeatherElement *find_weather_element(const std::string &name) const {
-    for (const auto &we : weather_elements) {
-      if (we.element_name == name)
-        return &we;
+  // Empties the record like release_data() but keeps its allocations for the
+  // next parse: elements move to spare_elements with their times capacity,
+  // and the pool buffer is reused unless a TimeSnapshot still references it.
+  void reset() {
+    this->spare_elements.reserve(this->spare_elements.size() + this->weather_elements.size());
+    for (auto &we : this->weather_elements) {
+      we.clear();
+      this->spare_elements.push_back(std::move(we));
     }
-    return nullptr;
+    this->weather_elements.clear();
+    if (this->string_pool && this->string_pool.use_count() == 1) {
+      this->string_pool->clear();
+    } else if (this->string_pool) {
+      this->string_pool = std::make_shared<StringPool>();
+    }
+    memset(this->daily_summary_valid, 0, sizeof(this->daily_summary_valid));
+    memset(this->element_slot, 0, sizeof(this->element_slot));
+    ++this->generation;
   }
 
-  const WeatherElement *get_weather_element_for_key(ElementValueKey key) const {
-    const char *name = find_mode_element_name(this->mode, key);
-    if (!name)
+  // Gives back the capacity reset() and parsing leave behind: spare
+  // elements are freed, vectors shrink to their size and the pool is
+  // compacted (dropped when the record is empty).
+  void trim() {
+    {
+      std::vector<WeatherElement, PsramAllocator<WeatherElement>> empty(this->spare_elements.get_allocator());
+      this->spare_elements.swap(empty);
+    }
+    for (auto &we : this->weather_elements) {
+      std::vector<Time, PsramAllocator<Time>> fitted(we.times.begin(), we.times.end(), we.times.get_allocator());
+      we.times.swap(fitted);
+    }
+    std::vector<WeatherElement, PsramAllocator<WeatherElement>> fitted(
+        std::make_move_iterator(this->weather_elements.begin()), std::make_move_iterator(this->weather_elements.end()),
+        this->weather_elements.get_allocator());
+    this->weather_elements.swap(fitted);
+    if (this->weather_elements.empty()) {
+      this->string_pool.reset();
+    } else {
+      this->compact_string_pool();
+    }
+  }
+
+  // Appends an empty element, reusing a spare one when reset() left any.
+  WeatherElement &add_element() {
+    if (this->spare_elements.empty()) {
+      this->weather_elements.emplace_back();
+    } else {
+      this->weather_elements.push_back(std::move(this->spare_elements.back()));
+      this->spare_elements.pop_back();
+    }
+    return this->weather_elements.back();
+  }
+
+  // Undoes add_element(), parking the element as a spare again.
+  void pop_element() {
+    this->weather_elements.back().clear();
+    this->spare_elements.push_back(std::move(this->weather_elements.back()));
+    this->weather_elements.pop_back();
+  }
+
+  // Builds the id -> element table so element lookups are direct index reads.
+  void index_elements() {
+    memset(this->element_slot, 0, sizeof(this->element_slot));
+    for (size_t i = 0; i < this->weather_elements.size() && i < 0xFF; ++i) {
+      const size_t id = static_cast<size_t>(this->weather_elements[i].id);
+      if (id < WEATHER_ELEMENT_ID_COUNT && this->element_slot[id] == 0)
+        this->element_slot[id] = static_cast<uint8_t>(i + 1);
+    }
+  }
+
+  // Calls fn(offset) for every element value offset in this record; the
+  // visitor StringPool::compacted() and wasted_bytes() expect.
+  template<typename F> void for_each_value_offset(F fn) {
+    for (auto &we : this->weather_elements)
+      for (auto &t : we.times)
+        for (auto &v : t.element_values)
+          fn(v.offset);
+  }
+  template<typename F> void for_each_value_offset(F fn) const {
+    for (const auto &we : this->weather_elements)
+      for (const auto &t : we.times)
+        for (const auto &v : t.element_values)
+          fn(v.offset);
+  }
+
+  // Recomputes start_time/end_time from the slots currently held.
+  void update_time_bounds();
+
+  // Earliest wall epoch after after_epoch at which some element's current
+  // slot changes (a DataTime point, or an interval start or end); 0 when no
+  // slot boundary lies ahead.
+  std::time_t next_slot_boundary(std::time_t after_epoch) const;
+
+  // Rebuilds daily_summaries from the slots currently held; call after
+  // update_time_bounds(). Interval slots count toward every day they overlap,
+  // matching find_min_max_values() over that day.
+  void build_daily_summaries();
+
+  // Day index of t relative to the summary base day (0 = first forecast day);
+  // may be negative or beyond MAX_SUMMARY_DAYS.
+  int day_index(const std::tm &t) const {
+    std::time_t diff = TimeField::to_wall_epoch(t) - this->summary_base_epoch;
+    return static_cast<int>(diff >= 0 ? diff / 86400 : (diff - 86399) / 86400);
+  }
+
+  // O(1) lookup of the precomputed min/max/mean for key on day_index; an
+  // invalid (all-NaN) summary for text-valued keys, out-of-range days, or
+  // days without data.
+  DailySummary daily_summary(int day_index, ElementValueKey key) const {
+    const int8_t k = numeric_key_index(key);
+    if (k < 0 || day_index < 0 || day_index >= static_cast<int>(MAX_SUMMARY_DAYS) ||
+        !(this->daily_summary_valid[day_index] & (1u << k)))
+      return DailySummary{NAN, NAN, NAN};
+    return this->daily_summaries[day_index][k];
+  }
+
+  // Drops slots that ended before cutoff (for DataTime series, all but the
+  // latest one at or before cutoff, which is still current) and compacts the
+  // string pool. Returns the number of slots removed.
+  size_t prune_before(const std::tm &cutoff);
+
+  // Rebuilds the string pool from live offsets, releasing unreferenced
+  // values. Time copies made earlier keep the previous pool alive.
+  void compact_string_pool();
+
+  // Serializes this record into out (replacing its contents) in the feed
+  // format described in forecast_feed.h; hash_code travels along so feed
+  // clients detect changes without rehashing.
+  void encode_feed(FeedBuffer &out, uint64_t hash_code) const;
+
+  // Bytes in the string pool not referenced by any slot; 0 when empty.
+  size_t string_pool_wasted_bytes() const {
+    if (!this->string_pool)
+      return 0;
+    return this->string_pool->wasted_bytes([this](auto fn) { this->for_each_value_offset(fn); });
+  }
+
+  const WeatherElement *find_weather_element(WeatherElementId id) const {
+    const size_t i = static_cast<size_t>(id);
+    if (i >= WEATHER_ELEMENT_ID_COUNT || this->element_slot[i] == 0)
       return nullptr;
-    return this->find_weather_element(name);
+    return &this->weather_elements[this->element_slot[i] - 1];
+  }
+
+  const WeatherElement *find_weather_element(const std::string &name) const {
+    return this->find_weather_element(parse_weather_element_id(name.c_str()));
+  }
+
+  const WeatherElement *get_weather_element_for_key(ElementValueKey key) const {
+    return this->find_weather_element(find_mode_element_id(this->mode, key));
   }
 
   const std::string find_value(ElementValueKey key, bool fallback_to_first_element, std::tm tm) const {
@@ -346,12 +700,35 @@ struct Record {
     if (!we)
       return default_value;
     if (Time *ts = we->match_time(tm, key, fallback_to_first_element)) {
-      auto val = ts->find_element_value(key);
+      auto val = we->find_element_value(*ts, key);
       return val.empty() ? default_value : val;
     }
     return default_value;
   }
 
+  // Value of key in a Time of this record (e.g. from find_range()).
+  std::string find_element_value(const Time &t, ElementValueKey key) const {
+    return t.find_element_value(key, this->string_pool.get());
+  }
+
+  // Slots of key's element inside [start, end) (see WeatherElement::range());
+  // empty when the element is absent.
+  TimeRange find_range(ElementValueKey key, const std::tm &start, const std::tm &end) const {
+    const WeatherElement *we = this->get_weather_element_for_key(key);
+    return we ? we->range(start, end) : TimeRange();
+  }
+
+  // WeatherElement::resample() on key's element with the key's
+  // default_resample_method(); all NaN when the element is absent.
+  size_t resample(ElementValueKey key, const std::tm &start, uint32_t step_seconds, float *out, size_t count) const {
+    const WeatherElement *we = this->get_weather_element_for_key(key);
+    if (!we) {
+      std::fill(out, out + count, NAN);
+      return 0;
+    }
+    return we->resample(key, start, step_seconds, out, count, default_resample_method(key));
+  }
+
   // True when t falls between sunrise and sunset at this record's location
   // (hour granularity, matching the WEATHER_ICON day/night selection).
   bool is_daytime(const std::tm &t) const;
@@ -363,10 +740,18 @@ struct Record {
                                     IconSet set = IconSet::WEATHER_ICONS) const;
 
   const std::pair<double, double> find_min_max_values(ElementValueKey key, std::tm &start, std::tm &end) const {
-    const WeatherElement *we = this->get_weather_element_for_key(key);
-    if (!we)
-      return std::make_pair(0.0, 0.0);
-    return get_min_max_element_value(we->filter_times(start, end), key);
+    // Whole-day queries ([00:00, 24:00) or through 23:59:59) on a numeric key
+    // are answered from the per-day table
+    std::time_t start_epoch = TimeField::to_wall_epoch(start);
+    std::time_t span = TimeField::to_wall_epoch(end) - start_epoch;
+    int day = this->day_index(start);
+    if ((span == 86400 || span == 86399) && numeric_key_index(key) >= 0 && this->string_pool && day >= 0 &&
+        day < static_cast<int>(MAX_SUMMARY_DAYS) && (start_epoch - this->summary_base_epoch) % 86400 == 0) {
+      DailySummary s = this->daily_summary(day, key);
+      return s.valid() ? std::make_pair(static_cast<double>(s.min), static_cast<double>(s.max))
+                       : std::make_pair(0.0, 0.0);
+    }
+    return get_min_max_element_value(this->find_range(key, start, end), key, this->string_pool.get());
   }
 
   void dump() const {
@@ -380,7 +765,7 @@ struct Record {
     ESP_LOGI(TAG, "  End Time: %s", tm_to_esptime(this->end_time).strftime("%Y-%m-%dT%H:%M:%S").c_str());
     ESP_LOGI(TAG, "  Updated Time: %s", tm_to_esptime(this->updated_time).strftime("%Y-%m-%dT%H:%M:%S").c_str());
     for (const auto &we : this->weather_elements) {
-      ESP_LOGI(TAG, "  Weather Element: %s", we.element_name.c_str());
+      ESP_LOGI(TAG, "  Weather Element: %s", we.name());
       for (const auto &t : we.times) {
         std::string datetime_str = "";
         if (t.data_time.is_valid()) {
@@ -406,6 +791,79 @@ struct Record {
   }
 };
 
+// One resampled series in a caller-owned buffer, recomputed only when the
+// Record's data changes or the requested grid moves, so chart lambdas can
+// call get() every frame:
+//
+//   static float temps[24];
+//   static SeriesCache cache(temps, 24);
+//   const float *v = cache.get(data, ElementValueKey::TEMPERATURE, hour_start, 3600, 24);
+class SeriesCache {
+ public:
+  SeriesCache(float *buffer, size_t capacity) : buffer_(buffer), capacity_(capacity) {}
+
+  // Returns the buffer filled with min(count, capacity) samples.
+  const float *get(const Record &record, ElementValueKey key, const std::tm &start, uint32_t step_seconds,
+                   size_t count) {
+    count = std::min(count, this->capacity_);
+    time_t start_epoch = TimeField::to_wall_epoch(start);
+    if (!this->filled_ || record.generation != this->generation_ || key != this->key_ ||
+        start_epoch != this->start_epoch_ || step_seconds != this->step_seconds_ || count != this->count_) {
+      this->valid_ = record.resample(key, start, step_seconds, this->buffer_, count);
+      this->filled_ = true;
+      this->generation_ = record.generation;
+      this->key_ = key;
+      this->start_epoch_ = start_epoch;
+      this->step_seconds_ = step_seconds;
+      this->count_ = count;
+    }
+    return this->buffer_;
+  }
+
+  // Non-NaN samples in the last computed series.
+  size_t valid_count() const { return this->valid_; }
+  // Forces the next get() to recompute.
+  void invalidate() { this->filled_ = false; }
+
+ protected:
+  float *buffer_;
+  size_t capacity_;
+  bool filled_{false};
+  uint32_t generation_{0};
+  ElementValueKey key_{ElementValueKey::TEMPERATURE};
+  time_t start_epoch_{0};
+  uint32_t step_seconds_{0};
+  size_t count_{0};
+  size_t valid_{0};
+};
+
+// Timings and memory figures of the last fetch, behind the diagnostic
+// sensors. Heap figures are internal RAM and only sampled while one of the
+// heap sensors is configured.
+struct FetchStats {
+  uint32_t connect_ms{0};     // http_request get(): DNS, TLS, request and response headers
+  uint32_t first_byte_ms{0};  // headers received until the first body bytes
+  uint32_t download_ms{0};    // waiting on body reads
+  uint32_t parse_ms{0};       // response processing minus download_ms
+  uint32_t hash_us{0};
+  uint32_t publish_ms{0};
+  size_t bytes_read{0};
+  size_t bytes_skipped{0};  // of bytes_read, passed over by bulk search rather than parsed
+  uint32_t slots_parsed{0};
+  size_t string_pool_bytes{0};
+  uint32_t dropped_slots{0};   // far-future slots over the memory budget
+  uint32_t dropped_values{0};  // values the string pool refused (budget or offset range)
+  size_t free_heap_before_parse{0};
+  size_t min_free_heap{0};
+  size_t min_largest_free_block{0};
+
+  // Largest drop in free heap while parsing
+  size_t peak_heap_usage() const {
+    return this->free_heap_before_parse > this->min_free_heap ? this->free_heap_before_parse - this->min_free_heap
+                                                              : 0;
+  }
+};
+
 class CWATownForecast : public PollingComponent {
  public:
   float get_setup_priority() const override;
@@ -434,19 +892,37 @@ class CWATownForecast : public PollingComponent {
 
   template<typename V> void set_time_to(V time_to) { time_to_ = time_to; }
 
+  void set_auto_weather_elements(bool auto_select) { auto_weather_elements_ = auto_select; }
+  // Declares a key read by lambdas through get_data() or on_data_change, so
+  // automatic ElementName selection keeps its element (lambda_keys option)
+  void add_required_key(ElementValueKey key) { this->required_keys_.push_back(key); }
+  void set_has_data_change_automation(bool has) { has_data_change_automation_ = has; }
+
   template<typename V> void set_sensor_expiry(V expiry) { sensor_expiry_ = expiry; }
 
   template<typename V> void set_fallback_to_first_element(V fallback) { fallback_to_first_element_ = fallback; }
 
   template<typename V> void set_retain_fetched_data(V retain) { retain_fetched_data_ = retain; }
+  template<typename V> void set_retain_capacity(V retain) { retain_capacity_ = retain; }
+  void set_memory_budget(uint32_t bytes) { memory_budget_ = bytes; }
 
   template<typename V> void set_early_data_clear(V early_data_clear) { early_data_clear_ = early_data_clear; }
 
   template<typename V> void set_retry_count(V retry_count) { retry_count_ = retry_count; }
 
   template<typename V> void set_retry_delay(V retry_delay) { retry_delay_ = retry_delay; }
-
-  void clear_data() { record_.release_data(); }
+  template<typename V> void set_republish_on_slot_change(V republish) { republish_on_slot_change_ = republish; }
+  template<typename V> void set_skip_unchanged_states(V skip) { skip_unchanged_states_ = skip; }
+  // Publishes skipped because the value matched the sensor's current state
+  uint32_t get_suppressed_publish_count() const { return this->suppressed_publishes_; }
+
+  void clear_data() { this->record_().release_data(); }
+  // Frees capacity kept for reuse across polls (see retain_capacity); the
+  // current data stays available.
+  void trim_data() {
+    this->record_().trim();
+    this->inactive_record_().release_data();
+  }
 
   Record &get_data();
 
@@ -485,27 +961,94 @@ class CWATownForecast : public PollingComponent {
   }
   void set_uv_index_sensor(sensor::Sensor *sensor) { uv_index_ = sensor; }
   void set_uv_exposure_level_text_sensor(text_sensor::TextSensor *sensor) { uv_exposure_level_ = sensor; }
+  void set_connect_time_sensor(sensor::Sensor *sensor) { connect_time_ = sensor; }
+  void set_first_byte_time_sensor(sensor::Sensor *sensor) { first_byte_time_ = sensor; }
+  void set_download_time_sensor(sensor::Sensor *sensor) { download_time_ = sensor; }
+  void set_parse_time_sensor(sensor::Sensor *sensor) { parse_time_ = sensor; }
+  void set_hash_time_sensor(sensor::Sensor *sensor) { hash_time_ = sensor; }
+  void set_publish_time_sensor(sensor::Sensor *sensor) { publish_time_ = sensor; }
+  void set_bytes_read_sensor(sensor::Sensor *sensor) { bytes_read_ = sensor; }
+  void set_bytes_skipped_sensor(sensor::Sensor *sensor) { bytes_skipped_ = sensor; }
+  void set_slots_parsed_sensor(sensor::Sensor *sensor) { slots_parsed_ = sensor; }
+  void set_string_pool_size_sensor(sensor::Sensor *sensor) { string_pool_size_ = sensor; }
+  void set_parse_peak_heap_sensor(sensor::Sensor *sensor) { parse_peak_heap_ = sensor; }
+  void set_parse_largest_free_block_sensor(sensor::Sensor *sensor) { parse_largest_free_block_ = sensor; }
+  void set_dropped_slots_sensor(sensor::Sensor *sensor) { dropped_slots_ = sensor; }
+  void set_dropped_values_sensor(sensor::Sensor *sensor) { dropped_values_ = sensor; }
+  void set_wake_to_publish_time_sensor(sensor::Sensor *sensor) { wake_to_publish_time_ = sensor; }
+  const FetchStats &get_fetch_stats() const { return this->fetch_stats_; }
   Trigger<Record &> *get_on_data_change_trigger() { return &this->on_data_change_trigger_; }
   Trigger<> *get_on_error_trigger() { return &this->on_error_trigger_; }
-  void set_http_request(http_request::HttpRequestComponent *http_request) { http_request_ = http_request; }
+  // Fires when update() is done: states published, fetched or not, or the
+  // fetch failed for good. Battery devices enter deep sleep from here.
+  Trigger<> *get_on_update_complete_trigger() { return &this->on_update_complete_trigger_; }
+  void set_http_request(http_request::HttpRequestComponent *http_request) {
+    http_request_ = http_request;
+    http_source_.set_http_request(http_request);
+  }
+  // Replaces the HTTP source, e.g. with a file or replay source; nullptr
+  // restores it
+  void set_source(ForecastSource *source) { source_ = source; }
+  ForecastSource *get_source() { return this->source_ != nullptr ? this->source_ : &this->http_source_; }
+  // Datastore endpoint the resource ID is appended to; point it at a mirror.
+  // A missing trailing slash is added, so ".../api" does not yield ".../apiF-D0047-069".
+  void set_base_url(const std::string &base_url) {
+    this->base_url_ = base_url;
+    if (!this->base_url_.empty() && this->base_url_.back() != '/')
+      this->base_url_ += '/';
+  }
+  // Fetches on CWA's issue cycle instead of (or besides) update_interval;
+  // times in seconds, see PublicationSchedule
+  void set_prefetch(uint32_t period, uint32_t offset, uint32_t delay, uint32_t jitter, uint32_t recheck) {
+    prefetch_ = true;
+    schedule_.configure(period, offset, delay, jitter, recheck);
+  }
+  const PublicationSchedule &get_schedule() const { return this->schedule_; }
+#ifdef CWA_SLEEP_STATE
+  // Keeps state across deep sleep in the RTC memory slot given (see SleepState)
+  void set_sleep_state_slot(uint8_t slot);
+#endif
+#ifdef CWA_FEED_SERVER
+  // Serves every successfully fetched record as a feed on GET path
+  void set_feed_server(web_server_base::WebServerBase *base, const std::string &path) {
+    feed_base_ = base;
+    feed_handler_.set_path(path);
+  }
+#endif
 
  protected:
   bool parse_to_record(HttpStreamAdapter &stream, Record &record, uint64_t &hash_code);
+  template<Mode M> bool parse_mode_(HttpStreamAdapter &stream, Record &record, uint64_t &hash_code);
 
   TemplatableValue<std::string> api_key_;
   TemplatableValue<std::string> city_name_;
   TemplatableValue<std::string> town_name_;
   Mode mode_;
   std::vector<std::string> weather_elements_;
+  bool auto_weather_elements_{true};
+  std::vector<ElementValueKey> required_keys_;
+  bool has_data_change_automation_{false};
   TemplatableValue<uint32_t> time_to_;
   TemplatableValue<EarlyDataClear> early_data_clear_;
   TemplatableValue<bool> fallback_to_first_element_;
   TemplatableValue<bool> retain_fetched_data_;
+  // Unset: keep allocations across polls only when PSRAM is present
+  TemplatableValue<bool> retain_capacity_;
+  // Bytes the parsed Record may occupy; 0 = unbounded
+  uint32_t memory_budget_{0};
   TemplatableValue<uint32_t> sensor_expiry_;
   TemplatableValue<uint32_t> retry_count_;
   TemplatableValue<uint32_t> retry_delay_;
   time::RealTimeClock *rtc_{nullptr};
   http_request::HttpRequestComponent *http_request_{nullptr};
+  HttpForecastSource http_source_;
+  ForecastSource *source_{nullptr};
+  std::string base_url_{DEFAULT_BASE_URL};
+#ifdef CWA_FEED_SERVER
+  web_server_base::WebServerBase *feed_base_{nullptr};
+  FeedHandler feed_handler_;
+  void publish_feed_(uint64_t hash_code);
+#endif
 
   text_sensor::TextSensor *city_sensor_{nullptr};
   text_sensor::TextSensor *town_sensor_{nullptr};
@@ -539,25 +1082,90 @@ class CWATownForecast : public PollingComponent {
   sensor::Sensor *uv_index_{nullptr};
   text_sensor::TextSensor *uv_exposure_level_{nullptr};
 
+  // Diagnostic sensors
+  sensor::Sensor *connect_time_{nullptr};
+  sensor::Sensor *first_byte_time_{nullptr};
+  sensor::Sensor *download_time_{nullptr};
+  sensor::Sensor *parse_time_{nullptr};
+  sensor::Sensor *hash_time_{nullptr};
+  sensor::Sensor *publish_time_{nullptr};
+  sensor::Sensor *bytes_read_{nullptr};
+  sensor::Sensor *bytes_skipped_{nullptr};
+  sensor::Sensor *slots_parsed_{nullptr};
+  sensor::Sensor *string_pool_size_{nullptr};
+  sensor::Sensor *parse_peak_heap_{nullptr};
+  sensor::Sensor *parse_largest_free_block_{nullptr};
+  sensor::Sensor *dropped_slots_{nullptr};
+  sensor::Sensor *dropped_values_{nullptr};
+  sensor::Sensor *wake_to_publish_time_{nullptr};
+  FetchStats fetch_stats_{};
+  // The first publish since boot (or deep sleep wake) was reported
+  bool wake_reported_{false};
+
   Trigger<Record &> on_data_change_trigger_{};
   Trigger<> on_error_trigger_{};
+  Trigger<> on_update_complete_trigger_{};
 
   uint64_t last_hash_code_{0};
-  Record record_;
+  // Double buffer: responses are parsed into the inactive slot and published
+  // by flipping active_record_, so a failed parse never touches live data
+  // (unless early_data_clear released it first) and steady-state polls refill
+  // the inactive slot's existing allocations.
+  Record records_[2];
+  uint8_t active_record_{0};
+  Record &record_() { return this->records_[this->active_record_]; }
+  Record &inactive_record_() { return this->records_[this->active_record_ ^ 1]; }
+  bool retains_capacity_();
+  // republish_on_slot_change, defaulting to retain_fetched_data
+  bool republishes_on_slot_change_();
+  // Empties record, keeping or freeing its allocations per retain_capacity
+  void clear_record_(Record &record);
   time_t sensor_expiration_time_{};
   bool retry_in_progress_{false};
+  TemplatableValue<bool> republish_on_slot_change_;
+  TemplatableValue<bool> skip_unchanged_states_;
+  uint32_t suppressed_publishes_{0};
+  bool prefetch_{false};
+  PublicationSchedule schedule_;
+  // The last response was a 304 to a conditional request
+  bool not_modified_{false};
+#ifdef CWA_SLEEP_STATE
+  SleepState *sleep_state_{nullptr};
+  // publish_states_() records into / publishes from the sleep state snapshot
+  bool snapshot_capture_{false};
+  bool snapshot_restore_{false};
+  // A sensor found no value in the snapshot while restoring
+  bool snapshot_missing_{false};
+  uint32_t query_hash_();
+  void restore_sleep_state_();
+  void save_sleep_state_(bool fetched);
+  bool fetch_needed_();
+  bool publish_snapshot_();
+#endif
 
   bool send_request_();
   void try_send_request_(uint32_t attempt);
   bool validate_config_();
+  bool derives_request_scope_();
+  std::vector<const char *> derive_weather_elements_();
   bool process_response_(HttpStreamAdapter &stream, uint64_t &hash_code);
+  bool load_feed_(HttpStreamAdapter &stream, Record &record, uint64_t &hash_code);
   bool check_changes(uint64_t new_hash_code);
   void publish_states_();
-  void publish_sensor_state_(sensor::Sensor *sensor, ElementValueKey key, std::tm &target_tm, bool fallback_to_first);
-  void publish_text_sensor_state_(text_sensor::TextSensor *sensor, ElementValueKey key, std::tm &target_tm,
+  void publish_fetch_stats_();
+  bool tracks_parse_heap_() const { return this->parse_peak_heap_ || this->parse_largest_free_block_; }
+  void sample_parse_heap_(bool largest_block);
+  void schedule_republish_();
+  void start_prefetch_();
+  void schedule_prefetch_(time_t first_slot);
+  void publish_if_changed_(sensor::Sensor *sensor, float value);
+  void publish_if_changed_(text_sensor::TextSensor *sensor, const std::string &value);
+  void publish_sensor_state_(sensor::Sensor *sensor, ElementValueKey key, std::time_t target_epoch,
+                             bool fallback_to_first);
+  void publish_text_sensor_state_(text_sensor::TextSensor *sensor, ElementValueKey key, std::time_t target_epoch,
                                   bool fallback_to_first);
   template<typename SensorT, typename PublishValFunc, typename PublishNoMatchFunc>
-  void publish_state_common_(SensorT *sensor, ElementValueKey key, std::tm &target_tm, bool fallback_to_first,
+  void publish_state_common_(SensorT *sensor, ElementValueKey key, std::time_t target_epoch, bool fallback_to_first,
                              PublishValFunc publish_val, PublishNoMatchFunc publish_no_match);
 };
 
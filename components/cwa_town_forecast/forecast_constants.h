@@ -53,6 +53,76 @@ static constexpr const char *const WEATHER_ELEMENT_NAME_MIN_COMFORT_INDEX = "最
 static constexpr const char *const WEATHER_ELEMENT_NAME_12H_PROBABILITY_OF_PRECIPITATION = "12小時降雨機率";
 static constexpr const char *const WEATHER_ELEMENT_NAME_UV_INDEX = "紫外線指數";
 
+// Compact identity of a weather element, mapped from its ElementName once at
+// ingest so lookups index tables instead of comparing UTF-8 strings.
+enum class WeatherElementId : uint8_t {
+  TEMPERATURE,
+  DEW_POINT,
+  APPARENT_TEMPERATURE,
+  COMFORT_INDEX,
+  WEATHER,
+  WEATHER_DESCRIPTION,
+  PROBABILITY_OF_PRECIPITATION_3H,
+  RELATIVE_HUMIDITY,
+  WIND_DIRECTION,
+  WIND_SPEED,
+  // New elements from 7 days forecast
+  AVG_TEMPERATURE,
+  MAX_TEMPERATURE,
+  MIN_TEMPERATURE,
+  AVG_DEW_POINT,
+  AVG_RELATIVE_HUMIDITY,
+  MAX_APPARENT_TEMPERATURE,
+  MIN_APPARENT_TEMPERATURE,
+  MAX_COMFORT_INDEX,
+  MIN_COMFORT_INDEX,
+  PROBABILITY_OF_PRECIPITATION_12H,
+  UV_INDEX,
+  UNKNOWN,
+};
+
+static constexpr size_t WEATHER_ELEMENT_ID_COUNT = static_cast<size_t>(WeatherElementId::UNKNOWN);
+
+// ElementName per WeatherElementId, in enum order
+static constexpr const char *const WEATHER_ELEMENT_ID_NAMES[WEATHER_ELEMENT_ID_COUNT] = {
+    WEATHER_ELEMENT_NAME_TEMPERATURE,
+    WEATHER_ELEMENT_NAME_DEW_POINT,
+    WEATHER_ELEMENT_NAME_APPARENT_TEMPERATURE,
+    WEATHER_ELEMENT_NAME_COMFORT_INDEX,
+    WEATHER_ELEMENT_NAME_WEATHER,
+    WEATHER_ELEMENT_NAME_WEATHER_DESCRIPTION,
+    WEATHER_ELEMENT_NAME_3H_PROBABILITY_OF_PRECIPITATION,
+    WEATHER_ELEMENT_NAME_RELATIVE_HUMIDITY,
+    WEATHER_ELEMENT_NAME_WIND_DIRECTION,
+    WEATHER_ELEMENT_NAME_WIND_SPEED,
+    WEATHER_ELEMENT_NAME_AVG_TEMPERATURE,
+    WEATHER_ELEMENT_NAME_MAX_TEMPERATURE,
+    WEATHER_ELEMENT_NAME_MIN_TEMPERATURE,
+    WEATHER_ELEMENT_NAME_AVG_DEW_POINT,
+    WEATHER_ELEMENT_NAME_AVG_RELATIVE_HUMIDITY,
+    WEATHER_ELEMENT_NAME_MAX_APPARENT_TEMPERATURE,
+    WEATHER_ELEMENT_NAME_MIN_APPARENT_TEMPERATURE,
+    WEATHER_ELEMENT_NAME_MAX_COMFORT_INDEX,
+    WEATHER_ELEMENT_NAME_MIN_COMFORT_INDEX,
+    WEATHER_ELEMENT_NAME_12H_PROBABILITY_OF_PRECIPITATION,
+    WEATHER_ELEMENT_NAME_UV_INDEX,
+};
+
+// ElementName of id; "" for UNKNOWN.
+inline const char *weather_element_name(WeatherElementId id) {
+  const size_t i = static_cast<size_t>(id);
+  return i < WEATHER_ELEMENT_ID_COUNT ? WEATHER_ELEMENT_ID_NAMES[i] : "";
+}
+
+// ElementName -> WeatherElementId; UNKNOWN for names outside both modes.
+inline WeatherElementId parse_weather_element_id(const char *name) {
+  for (size_t i = 0; i < WEATHER_ELEMENT_ID_COUNT; ++i) {
+    if (strcmp(name, WEATHER_ELEMENT_ID_NAMES[i]) == 0)
+      return static_cast<WeatherElementId>(i);
+  }
+  return WeatherElementId::UNKNOWN;
+}
+
 // Valid weather element names for 3 days forecasts (constexpr flash-resident array)
 static constexpr const char *const WEATHER_ELEMENT_NAMES_3DAYS[] = {
     WEATHER_ELEMENT_NAME_TEMPERATURE,
@@ -120,8 +190,17 @@ enum class ElementValueKey {
   UV_EXPOSURE_LEVEL
 };
 
+static constexpr size_t ELEMENT_VALUE_KEY_COUNT = static_cast<size_t>(ElementValueKey::UV_EXPOSURE_LEVEL) + 1;
+
+// Free-text keys a memory budget gives up first: the longest values, and
+// none of them backs a numeric sensor.
+constexpr bool is_low_priority_element_value_key(ElementValueKey key) {
+  return key == ElementValueKey::WEATHER_DESCRIPTION || key == ElementValueKey::COMFORT_INDEX_DESCRIPTION ||
+         key == ElementValueKey::MAX_COMFORT_INDEX_DESCRIPTION || key == ElementValueKey::MIN_COMFORT_INDEX_DESCRIPTION;
+}
+
 // Mapping of ElementValueKey enum to JSON field names
-static const std::pair<ElementValueKey, const char *> ELEMENT_VALUE_KEY_NAMES[] = {
+static constexpr std::pair<ElementValueKey, const char *> ELEMENT_VALUE_KEY_NAMES[] = {
     {ElementValueKey::TEMPERATURE, "Temperature"},
     {ElementValueKey::DEW_POINT, "DewPoint"},
     {ElementValueKey::APPARENT_TEMPERATURE, "ApparentTemperature"},
@@ -167,65 +246,207 @@ static inline bool parse_element_value_key(const char *key, ElementValueKey &out
   return false;
 }
 
-// Map ElementValueKey to WeatherElementName based on Mode (constexpr flat array)
+// Number of keys whose values are numeric (see numeric_key_index()).
+static constexpr size_t NUMERIC_ELEMENT_VALUE_KEY_COUNT = 15;
+
+// Dense index of a numeric ElementValueKey, used to address per-key numeric
+// tables; -1 for text-valued keys.
+inline constexpr int8_t numeric_key_index(ElementValueKey key) {
+  switch (key) {
+    case ElementValueKey::TEMPERATURE:
+      return 0;
+    case ElementValueKey::DEW_POINT:
+      return 1;
+    case ElementValueKey::APPARENT_TEMPERATURE:
+      return 2;
+    case ElementValueKey::COMFORT_INDEX:
+      return 3;
+    case ElementValueKey::RELATIVE_HUMIDITY:
+      return 4;
+    case ElementValueKey::WIND_SPEED:
+      return 5;
+    case ElementValueKey::BEAUFORT_SCALE:
+      return 6;
+    case ElementValueKey::PROBABILITY_OF_PRECIPITATION:
+      return 7;
+    case ElementValueKey::MAX_TEMPERATURE:
+      return 8;
+    case ElementValueKey::MIN_TEMPERATURE:
+      return 9;
+    case ElementValueKey::MAX_APPARENT_TEMPERATURE:
+      return 10;
+    case ElementValueKey::MIN_APPARENT_TEMPERATURE:
+      return 11;
+    case ElementValueKey::MAX_COMFORT_INDEX:
+      return 12;
+    case ElementValueKey::MIN_COMFORT_INDEX:
+      return 13;
+    case ElementValueKey::UV_INDEX:
+      return 14;
+    default:
+      return -1;
+  }
+}
+
+// How WeatherElement::resample() fills grid points between forecast slots.
+enum class ResampleMethod : uint8_t {
+  LINEAR,  // interpolate between neighbouring slots (continuous quantities)
+  STEP,    // hold the value of the slot covering the grid point
+};
+
+// Linear for continuous quantities (temperatures, humidity, comfort index,
+// wind speed); step for categorical or per-period values such as
+// probability of precipitation, Beaufort scale and UV index.
+inline constexpr ResampleMethod default_resample_method(ElementValueKey key) {
+  switch (key) {
+    case ElementValueKey::TEMPERATURE:
+    case ElementValueKey::DEW_POINT:
+    case ElementValueKey::APPARENT_TEMPERATURE:
+    case ElementValueKey::COMFORT_INDEX:
+    case ElementValueKey::RELATIVE_HUMIDITY:
+    case ElementValueKey::WIND_SPEED:
+    case ElementValueKey::MAX_TEMPERATURE:
+    case ElementValueKey::MIN_TEMPERATURE:
+    case ElementValueKey::MAX_APPARENT_TEMPERATURE:
+    case ElementValueKey::MIN_APPARENT_TEMPERATURE:
+    case ElementValueKey::MAX_COMFORT_INDEX:
+    case ElementValueKey::MIN_COMFORT_INDEX:
+      return ResampleMethod::LINEAR;
+    default:
+      return ResampleMethod::STEP;
+  }
+}
+
+// Map ElementValueKey to WeatherElementId based on Mode (constexpr flat array)
 struct ModeElementMapping {
   Mode mode;
   ElementValueKey key;
-  const char *element_name;
+  WeatherElementId element;
 };
 
 static constexpr ModeElementMapping MODE_ELEMENT_MAPPINGS[] = {
     // --- THREE_DAYS ---
-    {Mode::THREE_DAYS, ElementValueKey::TEMPERATURE, WEATHER_ELEMENT_NAME_TEMPERATURE},
-    {Mode::THREE_DAYS, ElementValueKey::DEW_POINT, WEATHER_ELEMENT_NAME_DEW_POINT},
-    {Mode::THREE_DAYS, ElementValueKey::APPARENT_TEMPERATURE, WEATHER_ELEMENT_NAME_APPARENT_TEMPERATURE},
-    {Mode::THREE_DAYS, ElementValueKey::COMFORT_INDEX, WEATHER_ELEMENT_NAME_COMFORT_INDEX},
-    {Mode::THREE_DAYS, ElementValueKey::COMFORT_INDEX_DESCRIPTION, WEATHER_ELEMENT_NAME_COMFORT_INDEX},
-    {Mode::THREE_DAYS, ElementValueKey::WEATHER, WEATHER_ELEMENT_NAME_WEATHER},
-    {Mode::THREE_DAYS, ElementValueKey::WEATHER_CODE, WEATHER_ELEMENT_NAME_WEATHER},
-    {Mode::THREE_DAYS, ElementValueKey::WEATHER_ICON, WEATHER_ELEMENT_NAME_WEATHER},
-    {Mode::THREE_DAYS, ElementValueKey::WEATHER_DESCRIPTION, WEATHER_ELEMENT_NAME_WEATHER_DESCRIPTION},
+    {Mode::THREE_DAYS, ElementValueKey::TEMPERATURE, WeatherElementId::TEMPERATURE},
+    {Mode::THREE_DAYS, ElementValueKey::DEW_POINT, WeatherElementId::DEW_POINT},
+    {Mode::THREE_DAYS, ElementValueKey::APPARENT_TEMPERATURE, WeatherElementId::APPARENT_TEMPERATURE},
+    {Mode::THREE_DAYS, ElementValueKey::COMFORT_INDEX, WeatherElementId::COMFORT_INDEX},
+    {Mode::THREE_DAYS, ElementValueKey::COMFORT_INDEX_DESCRIPTION, WeatherElementId::COMFORT_INDEX},
+    {Mode::THREE_DAYS, ElementValueKey::WEATHER, WeatherElementId::WEATHER},
+    {Mode::THREE_DAYS, ElementValueKey::WEATHER_CODE, WeatherElementId::WEATHER},
+    {Mode::THREE_DAYS, ElementValueKey::WEATHER_ICON, WeatherElementId::WEATHER},
+    {Mode::THREE_DAYS, ElementValueKey::WEATHER_DESCRIPTION, WeatherElementId::WEATHER_DESCRIPTION},
     {Mode::THREE_DAYS, ElementValueKey::PROBABILITY_OF_PRECIPITATION,
-     WEATHER_ELEMENT_NAME_3H_PROBABILITY_OF_PRECIPITATION},
-    {Mode::THREE_DAYS, ElementValueKey::RELATIVE_HUMIDITY, WEATHER_ELEMENT_NAME_RELATIVE_HUMIDITY},
-    {Mode::THREE_DAYS, ElementValueKey::WIND_DIRECTION, WEATHER_ELEMENT_NAME_WIND_DIRECTION},
-    {Mode::THREE_DAYS, ElementValueKey::WIND_SPEED, WEATHER_ELEMENT_NAME_WIND_SPEED},
-    {Mode::THREE_DAYS, ElementValueKey::BEAUFORT_SCALE, WEATHER_ELEMENT_NAME_WIND_SPEED},
+     WeatherElementId::PROBABILITY_OF_PRECIPITATION_3H},
+    {Mode::THREE_DAYS, ElementValueKey::RELATIVE_HUMIDITY, WeatherElementId::RELATIVE_HUMIDITY},
+    {Mode::THREE_DAYS, ElementValueKey::WIND_DIRECTION, WeatherElementId::WIND_DIRECTION},
+    {Mode::THREE_DAYS, ElementValueKey::WIND_SPEED, WeatherElementId::WIND_SPEED},
+    {Mode::THREE_DAYS, ElementValueKey::BEAUFORT_SCALE, WeatherElementId::WIND_SPEED},
     // --- SEVEN_DAYS ---
-    {Mode::SEVEN_DAYS, ElementValueKey::TEMPERATURE, WEATHER_ELEMENT_NAME_AVG_TEMPERATURE},
-    {Mode::SEVEN_DAYS, ElementValueKey::DEW_POINT, WEATHER_ELEMENT_NAME_AVG_DEW_POINT},
-    {Mode::SEVEN_DAYS, ElementValueKey::RELATIVE_HUMIDITY, WEATHER_ELEMENT_NAME_AVG_RELATIVE_HUMIDITY},
-    {Mode::SEVEN_DAYS, ElementValueKey::MAX_TEMPERATURE, WEATHER_ELEMENT_NAME_MAX_TEMPERATURE},
-    {Mode::SEVEN_DAYS, ElementValueKey::MIN_TEMPERATURE, WEATHER_ELEMENT_NAME_MIN_TEMPERATURE},
-    {Mode::SEVEN_DAYS, ElementValueKey::MAX_APPARENT_TEMPERATURE, WEATHER_ELEMENT_NAME_MAX_APPARENT_TEMPERATURE},
-    {Mode::SEVEN_DAYS, ElementValueKey::MIN_APPARENT_TEMPERATURE, WEATHER_ELEMENT_NAME_MIN_APPARENT_TEMPERATURE},
-    {Mode::SEVEN_DAYS, ElementValueKey::MAX_COMFORT_INDEX, WEATHER_ELEMENT_NAME_MAX_COMFORT_INDEX},
-    {Mode::SEVEN_DAYS, ElementValueKey::MIN_COMFORT_INDEX, WEATHER_ELEMENT_NAME_MIN_COMFORT_INDEX},
-    {Mode::SEVEN_DAYS, ElementValueKey::MIN_COMFORT_INDEX_DESCRIPTION, WEATHER_ELEMENT_NAME_MIN_COMFORT_INDEX},
-    {Mode::SEVEN_DAYS, ElementValueKey::MAX_COMFORT_INDEX_DESCRIPTION, WEATHER_ELEMENT_NAME_MAX_COMFORT_INDEX},
+    {Mode::SEVEN_DAYS, ElementValueKey::TEMPERATURE, WeatherElementId::AVG_TEMPERATURE},
+    {Mode::SEVEN_DAYS, ElementValueKey::DEW_POINT, WeatherElementId::AVG_DEW_POINT},
+    {Mode::SEVEN_DAYS, ElementValueKey::RELATIVE_HUMIDITY, WeatherElementId::AVG_RELATIVE_HUMIDITY},
+    {Mode::SEVEN_DAYS, ElementValueKey::MAX_TEMPERATURE, WeatherElementId::MAX_TEMPERATURE},
+    {Mode::SEVEN_DAYS, ElementValueKey::MIN_TEMPERATURE, WeatherElementId::MIN_TEMPERATURE},
+    {Mode::SEVEN_DAYS, ElementValueKey::MAX_APPARENT_TEMPERATURE, WeatherElementId::MAX_APPARENT_TEMPERATURE},
+    {Mode::SEVEN_DAYS, ElementValueKey::MIN_APPARENT_TEMPERATURE, WeatherElementId::MIN_APPARENT_TEMPERATURE},
+    {Mode::SEVEN_DAYS, ElementValueKey::MAX_COMFORT_INDEX, WeatherElementId::MAX_COMFORT_INDEX},
+    {Mode::SEVEN_DAYS, ElementValueKey::MIN_COMFORT_INDEX, WeatherElementId::MIN_COMFORT_INDEX},
+    {Mode::SEVEN_DAYS, ElementValueKey::MIN_COMFORT_INDEX_DESCRIPTION, WeatherElementId::MIN_COMFORT_INDEX},
+    {Mode::SEVEN_DAYS, ElementValueKey::MAX_COMFORT_INDEX_DESCRIPTION, WeatherElementId::MAX_COMFORT_INDEX},
     {Mode::SEVEN_DAYS, ElementValueKey::PROBABILITY_OF_PRECIPITATION,
-     WEATHER_ELEMENT_NAME_12H_PROBABILITY_OF_PRECIPITATION},
-    {Mode::SEVEN_DAYS, ElementValueKey::UV_INDEX, WEATHER_ELEMENT_NAME_UV_INDEX},
-    {Mode::SEVEN_DAYS, ElementValueKey::WEATHER, WEATHER_ELEMENT_NAME_WEATHER},
-    {Mode::SEVEN_DAYS, ElementValueKey::WEATHER_CODE, WEATHER_ELEMENT_NAME_WEATHER},
-    {Mode::SEVEN_DAYS, ElementValueKey::WEATHER_ICON, WEATHER_ELEMENT_NAME_WEATHER},
-    {Mode::SEVEN_DAYS, ElementValueKey::WEATHER_DESCRIPTION, WEATHER_ELEMENT_NAME_WEATHER_DESCRIPTION},
-    {Mode::SEVEN_DAYS, ElementValueKey::WIND_DIRECTION, WEATHER_ELEMENT_NAME_WIND_DIRECTION},
-    {Mode::SEVEN_DAYS, ElementValueKey::WIND_SPEED, WEATHER_ELEMENT_NAME_WIND_SPEED},
-    {Mode::SEVEN_DAYS, ElementValueKey::BEAUFORT_SCALE, WEATHER_ELEMENT_NAME_WIND_SPEED},
-    {Mode::SEVEN_DAYS, ElementValueKey::UV_EXPOSURE_LEVEL, WEATHER_ELEMENT_NAME_UV_INDEX},
+     WeatherElementId::PROBABILITY_OF_PRECIPITATION_12H},
+    {Mode::SEVEN_DAYS, ElementValueKey::UV_INDEX, WeatherElementId::UV_INDEX},
+    {Mode::SEVEN_DAYS, ElementValueKey::WEATHER, WeatherElementId::WEATHER},
+    {Mode::SEVEN_DAYS, ElementValueKey::WEATHER_CODE, WeatherElementId::WEATHER},
+    {Mode::SEVEN_DAYS, ElementValueKey::WEATHER_ICON, WeatherElementId::WEATHER},
+    {Mode::SEVEN_DAYS, ElementValueKey::WEATHER_DESCRIPTION, WeatherElementId::WEATHER_DESCRIPTION},
+    {Mode::SEVEN_DAYS, ElementValueKey::WIND_DIRECTION, WeatherElementId::WIND_DIRECTION},
+    {Mode::SEVEN_DAYS, ElementValueKey::WIND_SPEED, WeatherElementId::WIND_SPEED},
+    {Mode::SEVEN_DAYS, ElementValueKey::BEAUFORT_SCALE, WeatherElementId::WIND_SPEED},
+    {Mode::SEVEN_DAYS, ElementValueKey::UV_EXPOSURE_LEVEL, WeatherElementId::UV_INDEX},
 };
 
 static constexpr size_t MODE_ELEMENT_MAPPINGS_SIZE = sizeof(MODE_ELEMENT_MAPPINGS) / sizeof(MODE_ELEMENT_MAPPINGS[0]);
 
+// MODE_ELEMENT_MAPPINGS expanded at compile time into a [mode][key] table so
+// the key -> element step is a single array read.
+struct ModeKeyElementTable {
+  WeatherElementId ids[2][ELEMENT_VALUE_KEY_COUNT];
+};
+
+inline constexpr ModeKeyElementTable build_mode_key_element_table() {
+  ModeKeyElementTable table{};
+  for (auto &row : table.ids)
+    for (auto &id : row)
+      id = WeatherElementId::UNKNOWN;
+  for (const auto &m : MODE_ELEMENT_MAPPINGS)
+    table.ids[m.mode][static_cast<size_t>(m.key)] = m.element;
+  return table;
+}
+
+static constexpr ModeKeyElementTable MODE_KEY_ELEMENT_IDS = build_mode_key_element_table();
+
+// Element holding key in mode; UNKNOWN when the mode has no such key.
+inline constexpr WeatherElementId find_mode_element_id(Mode mode, ElementValueKey key) {
+  return MODE_KEY_ELEMENT_IDS.ids[mode][static_cast<size_t>(key)];
+}
+
 // Look up element name for a given mode and key
 inline const char *find_mode_element_name(Mode mode, ElementValueKey key) {
-  for (size_t i = 0; i < MODE_ELEMENT_MAPPINGS_SIZE; ++i) {
-    if (MODE_ELEMENT_MAPPINGS[i].mode == mode && MODE_ELEMENT_MAPPINGS[i].key == key) {
-      return MODE_ELEMENT_MAPPINGS[i].element_name;
+  WeatherElementId id = find_mode_element_id(mode, key);
+  return id == WeatherElementId::UNKNOWN ? nullptr : weather_element_name(id);
+}
+
+// JSON field name of key, usable in constant expressions
+inline constexpr const char *element_value_key_name(ElementValueKey key) {
+  for (const auto &p : ELEMENT_VALUE_KEY_NAMES) {
+    if (p.first == key)
+      return p.second;
+  }
+  return "";
+}
+
+inline constexpr size_t mode_element_value_key_count(Mode mode) {
+  size_t n = 0;
+  for (const auto &m : MODE_ELEMENT_MAPPINGS) {
+    if (m.mode == mode)
+      ++n;
+  }
+  return n;
+}
+
+struct ElementValueKeyName {
+  ElementValueKey key;
+  const char *name;
+};
+
+// The ElementValue keys a mode can carry, derived from MODE_ELEMENT_MAPPINGS
+// at compile time so each mode's parser only compares against its own keys.
+template<Mode M> struct ModeElementValueKeys {
+  ElementValueKeyName entries[mode_element_value_key_count(M)];
+};
+
+template<Mode M> inline constexpr ModeElementValueKeys<M> build_mode_element_value_keys() {
+  ModeElementValueKeys<M> keys{};
+  size_t n = 0;
+  for (const auto &m : MODE_ELEMENT_MAPPINGS) {
+    if (m.mode == M)
+      keys.entries[n++] = {m.key, element_value_key_name(m.key)};
+  }
+  return keys;
+}
+
+template<Mode M> inline constexpr ModeElementValueKeys<M> MODE_ELEMENT_VALUE_KEYS = build_mode_element_value_keys<M>();
+
+// parse_element_value_key() restricted to the keys valid in mode M
+template<Mode M> inline bool parse_mode_element_value_key(const char *key, ElementValueKey &out) {
+  for (const auto &e : MODE_ELEMENT_VALUE_KEYS<M>.entries) {
+    if (strcmp(key, e.name) == 0) {
+      out = e.key;
+      return true;
     }
   }
-  return nullptr;
+  return false;
 }
 
 // Icon sets available for weather-code-to-icon lookups.
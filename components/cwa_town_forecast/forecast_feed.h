@@ -0,0 +1,188 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+
+#ifdef CWA_FEED_SERVER
+#include "esphome/components/web_server_base/web_server_base.h"
+#endif
+
+#include "http_stream_adapter.h"
+#include "psram_allocator.h"
+
+namespace esphome {
+namespace cwa_town_forecast {
+
+// Binary "feed" of a parsed Record: one node fetches and parses the CWA
+// response and serves the result (see Record::encode_feed()), other nodes
+// load it without parsing JSON (FeedForecastSource). Integers are
+// little-endian:
+//
+//   "CWAF" version:u8 mode:u8 offset_bytes:u8 element_count:u8 hash:u64
+//   updated:i64 latitude:f64 longitude:f64 locations_name:str
+//   location_name:str pool_size:u32 pool:bytes[pool_size]
+//   per element:  id:u8 slot_count:u16
+//     per slot:   flags:u8 (FeedSlotFlags, value count in the high nibble)
+//                 one u32 per time field present
+//     per value:  key:u8 offset:u16|u32 (offset_bytes)
+//
+// str is a u16 length and the bytes; times are wall-clock seconds since
+// FEED_EPOCH_BASE, the range TimeField stores. A full 3-day response comes
+// to ~10 KB, against ~130 KB of JSON.
+static constexpr char FEED_MAGIC[4] = {'C', 'W', 'A', 'F'};
+static constexpr uint8_t FEED_VERSION = 1;
+static constexpr int64_t FEED_EPOCH_BASE = 946684800;  // 2000-01-01 00:00:00 wall
+static constexpr const char *const FEED_CONTENT_TYPE = "application/octet-stream";
+
+enum FeedSlotFlags : uint8_t {
+  FEED_DATA_TIME = 1 << 0,
+  FEED_START_TIME = 1 << 1,
+  FEED_END_TIME = 1 << 2,
+};
+
+using FeedBuffer = std::vector<uint8_t, PsramAllocator<uint8_t>>;
+
+// Appends feed fields to a FeedBuffer.
+class FeedWriter {
+ public:
+  explicit FeedWriter(FeedBuffer &out) : out_(out) {}
+
+  void u8(uint8_t v) { this->out_.push_back(v); }
+  void u16(uint16_t v) { this->put_(v, 2); }
+  void u32(uint32_t v) { this->put_(v, 4); }
+  void u64(uint64_t v) { this->put_(v, 8); }
+  void f64(double v) {
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    this->u64(bits);
+  }
+  void bytes(const void *data, size_t n) {
+    const uint8_t *p = static_cast<const uint8_t *>(data);
+    this->out_.insert(this->out_.end(), p, p + n);
+  }
+  void str(const std::string &s) {
+    const uint16_t n = static_cast<uint16_t>(std::min<size_t>(s.size(), UINT16_MAX));
+    this->u16(n);
+    this->bytes(s.data(), n);
+  }
+
+  static size_t str_size(const std::string &s) { return 2 + std::min<size_t>(s.size(), UINT16_MAX); }
+
+ protected:
+  void put_(uint64_t v, int n) {
+    for (int i = 0; i < n; ++i)
+      this->out_.push_back(static_cast<uint8_t>(v >> (8 * i)));
+  }
+
+  FeedBuffer &out_;
+};
+
+// Reads feed fields from the response stream. A short read latches ok() to
+// false and makes every later read return zeros, so callers check once per
+// record section instead of after every field.
+class FeedReader {
+ public:
+  explicit FeedReader(HttpStreamAdapter &stream) : stream_(stream) {}
+
+  bool ok() const { return this->ok_; }
+
+  bool bytes(void *dst, size_t n) {
+    if (this->ok_)
+      this->ok_ = this->stream_.readBytes(static_cast<char *>(dst), n) == n;
+    if (!this->ok_)
+      memset(dst, 0, n);
+    return this->ok_;
+  }
+  uint8_t u8() { return static_cast<uint8_t>(this->get_(1)); }
+  uint16_t u16() { return static_cast<uint16_t>(this->get_(2)); }
+  uint32_t u32() { return static_cast<uint32_t>(this->get_(4)); }
+  uint64_t u64() { return this->get_(8); }
+  double f64() {
+    uint64_t bits = this->u64();
+    double v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+  }
+  void str(std::string &out) {
+    const uint16_t n = this->u16();
+    out.resize(n);
+    if (n > 0)
+      this->bytes(&out[0], n);
+  }
+
+ protected:
+  uint64_t get_(int n) {
+    uint8_t b[8];
+    this->bytes(b, n);
+    uint64_t v = 0;
+    for (int i = 0; i < n; ++i)
+      v |= static_cast<uint64_t>(b[i]) << (8 * i);
+    return v;
+  }
+
+  HttpStreamAdapter &stream_;
+  bool ok_{true};
+};
+
+#ifdef CWA_FEED_SERVER
+// Serves the latest feed on GET path. publish() runs on the main loop while
+// the web server task may be sending the previous feed, so the buffer is
+// swapped under a lock and each response keeps its own reference until sent.
+class FeedHandler : public AsyncWebHandler {
+ public:
+  void set_path(const std::string &path) { this->path_ = path; }
+  const std::string &get_path() const { return this->path_; }
+
+  void publish(std::shared_ptr<const FeedBuffer> feed) {
+    LockGuard guard(this->lock_);
+    this->feed_ = std::move(feed);
+  }
+
+  bool canHandle(AsyncWebServerRequest *request) const override {
+    // url() is a String on ESPAsyncWebServer, which only compares to const char *
+    return request->method() == HTTP_GET && request->url() == this->path_.c_str();
+  }
+
+  void handleRequest(AsyncWebServerRequest *request) override {
+    std::shared_ptr<const FeedBuffer> feed;
+    {
+      LockGuard guard(this->lock_);
+      feed = this->feed_;
+    }
+    if (!feed) {
+      request->send(503, "text/plain", "No forecast data yet");
+      return;
+    }
+#ifdef USE_ARDUINO
+    // ESPAsyncWebServer sends after handleRequest() returns; the filler's
+    // reference keeps the buffer alive until the response is done with it
+    request->send(request->beginResponse(FEED_CONTENT_TYPE, feed->size(),
+                                         [feed](uint8_t *buf, size_t max_len, size_t index) -> size_t {
+                                           if (index >= feed->size())
+                                             return 0;
+                                           const size_t n = std::min(max_len, feed->size() - index);
+                                           memcpy(buf, feed->data() + index, n);
+                                           return n;
+                                         }));
+#else
+    // web_server_idf sends the body before send() returns, while feed is held
+    request->send(request->beginResponse(200, FEED_CONTENT_TYPE, feed->data(), feed->size()));
+#endif
+  }
+
+ protected:
+  std::string path_;
+  std::shared_ptr<const FeedBuffer> feed_;
+  Mutex lock_;
+};
+#endif
+
+}  // namespace cwa_town_forecast
+}  // namespace esphome
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "esphome/components/http_request/http_request.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace cwa_town_forecast {
+
+/// Where forecast responses come from. open() hands back the body as an
+/// http_request::HttpContainer, so HttpStreamAdapter and the parser run
+/// unchanged whether it arrives over HTTPS, from a file or from RAM.
+class ForecastSource {
+ public:
+  virtual ~ForecastSource() = default;
+
+  /// Opens the response for url. nullptr when nothing could be opened;
+  /// otherwise status_code reports the outcome like HTTP does (200 = OK).
+  virtual std::shared_ptr<http_request::HttpContainer> open(const std::string &url) = 0;
+
+  /// Whether open() needs a network connection.
+  virtual bool needs_network() const { return false; }
+
+  /// Whether the query must carry a CWA API key.
+  virtual bool needs_api_key() const { return false; }
+
+  /// Makes the following open() calls conditional: status 304 means the
+  /// response tagged etag is still current. Empty for unconditional ones.
+  virtual void set_if_none_match(const std::string &etag) {}
+
+  /// ETag of the response last opened; empty if it had none.
+  virtual std::string get_etag() const { return ""; }
+
+  virtual const char *name() const = 0;
+};
+
+/// The CWA open data API (or a mirror of it) through ESPHome's http_request.
+class HttpForecastSource : public ForecastSource {
+ public:
+  explicit HttpForecastSource(http_request::HttpRequestComponent *http_request = nullptr)
+      : http_request_(http_request) {}
+
+  void set_http_request(http_request::HttpRequestComponent *http_request) { http_request_ = http_request; }
+
+  std::shared_ptr<http_request::HttpContainer> open(const std::string &url) override {
+    this->etag_.clear();
+    if (this->http_request_ == nullptr)
+      return nullptr;
+    std::list<http_request::Header> headers;
+    if (!this->if_none_match_.empty())
+      headers.push_back({"If-None-Match", this->if_none_match_});
+    auto container = this->http_request_->get(url, headers, {"etag"});
+    if (container != nullptr)
+      this->etag_ = container->get_response_header("etag");
+    return container;
+  }
+
+  bool needs_network() const override { return true; }
+  bool needs_api_key() const override { return true; }
+  void set_if_none_match(const std::string &etag) override { this->if_none_match_ = etag; }
+  std::string get_etag() const override { return this->etag_; }
+  const char *name() const override { return "http"; }
+
+ protected:
+  http_request::HttpRequestComponent *http_request_;
+  std::string if_none_match_;
+  std::string etag_;
+};
+
+/// Another node's feed (see FeedHandler): the Record it already parsed, in
+/// binary form, fetched from url whatever the query would have been.
+class FeedForecastSource : public HttpForecastSource {
+ public:
+  explicit FeedForecastSource(std::string url) : url_(std::move(url)) {}
+
+  std::shared_ptr<http_request::HttpContainer> open(const std::string &url) override {
+    return HttpForecastSource::open(this->url_);
+  }
+
+  bool needs_api_key() const override { return false; }
+  const char *name() const override { return "feed"; }
+
+ protected:
+  std::string url_;
+};
+
+/// Serves a caller-owned buffer; the buffer must outlive the container.
+class BufferContainer : public http_request::HttpContainer {
+ public:
+  BufferContainer(const uint8_t *data, size_t size) : data_(data) {
+    this->content_length = size;
+    this->status_code = size > 0 ? 200 : 204;
+    this->duration_ms = 0;
+  }
+
+  int read(uint8_t *buf, size_t max_len) override {
+    size_t n = std::min(max_len, this->content_length - this->bytes_read_);
+    memcpy(buf, this->data_ + this->bytes_read_, n);
+    this->bytes_read_ += n;
+    return static_cast<int>(n);
+  }
+
+  void end() override {}
+
+ protected:
+  const uint8_t *data_;
+};
+
+/// Serves a file from a mounted VFS filesystem (e.g. LittleFS at /littlefs).
+class FileContainer : public http_request::HttpContainer {
+ public:
+  explicit FileContainer(const std::string &path) : file_(std::fopen(path.c_str(), "rb")) {
+    this->content_length = 0;
+    this->duration_ms = 0;
+    if (this->file_ != nullptr && std::fseek(this->file_, 0, SEEK_END) == 0) {
+      long size = std::ftell(this->file_);
+      std::fseek(this->file_, 0, SEEK_SET);
+      this->content_length = size > 0 ? static_cast<size_t>(size) : 0;
+    }
+    this->status_code = this->file_ == nullptr ? 404 : (this->content_length > 0 ? 200 : 204);
+  }
+  ~FileContainer() override { this->end(); }
+
+  int read(uint8_t *buf, size_t max_len) override {
+    if (this->file_ == nullptr)
+      return -1;
+    size_t n = std::fread(buf, 1, max_len, this->file_);
+    if (n == 0 && std::ferror(this->file_))
+      return -1;
+    this->bytes_read_ += n;
+    return static_cast<int>(n);
+  }
+
+  void end() override {
+    if (this->file_ != nullptr) {
+      std::fclose(this->file_);
+      this->file_ = nullptr;
+    }
+  }
+
+ protected:
+  FILE *file_;
+};
+
+/// A fixed in-memory response, e.g. an embedded recording for benchmarks.
+class BufferForecastSource : public ForecastSource {
+ public:
+  BufferForecastSource(const uint8_t *data, size_t size) : data_(data), size_(size) {}
+
+  std::shared_ptr<http_request::HttpContainer> open(const std::string &url) override {
+    return std::make_shared<BufferContainer>(this->data_, this->size_);
+  }
+
+  const char *name() const override { return "buffer"; }
+
+ protected:
+  const uint8_t *data_;
+  size_t size_;
+};
+
+/// One response file, served on every fetch regardless of the query.
+class FileForecastSource : public ForecastSource {
+ public:
+  explicit FileForecastSource(std::string path) : path_(std::move(path)) {}
+
+  std::shared_ptr<http_request::HttpContainer> open(const std::string &url) override {
+    ESP_LOGD("cwa_town_forecast", "Reading forecast from %s", this->path_.c_str());
+    return std::make_shared<FileContainer>(this->path_);
+  }
+
+  const char *name() const override { return "file"; }
+
+ protected:
+  std::string path_;
+};
+
+/// Recorded responses played back in order, one per fetch, starting over
+/// after the last one; for soak tests that need the data to change.
+class ReplayForecastSource : public ForecastSource {
+ public:
+  void add_path(const std::string &path) { this->paths_.push_back(path); }
+
+  std::shared_ptr<http_request::HttpContainer> open(const std::string &url) override {
+    if (this->paths_.empty())
+      return nullptr;
+    const std::string &path = this->paths_[this->next_];
+    ESP_LOGD("cwa_town_forecast", "Replaying recording %zu/%zu: %s", this->next_ + 1, this->paths_.size(),
+             path.c_str());
+    this->next_ = (this->next_ + 1) % this->paths_.size();
+    return std::make_shared<FileContainer>(path);
+  }
+
+  const char *name() const override { return "replay"; }
+
+ protected:
+  std::vector<std::string> paths_;
+  size_t next_{0};
+};
+
+}  // namespace cwa_town_forecast
+}  // namespace esphome
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <cstring>
 #include <memory>
 #include <string>
@@ -28,7 +30,8 @@ class HttpStreamAdapter {
         total_bytes_read_(0),
         eof_(false),
         timeout_ms_(timeout_ms),
-        last_data_time_(millis()) {
+        last_data_time_(millis()),
+        created_time_(last_data_time_) {
     if (buffer_size < MIN_BUFFER_SIZE)
       buffer_size = MIN_BUFFER_SIZE;
     if (buffer_size > MAX_BUFFER_SIZE)
@@ -45,6 +48,8 @@ class HttpStreamAdapter {
   /// Read one byte. Returns -1 on EOF.
   /// This method satisfies ArduinoJson's reader concept.
   int read() {
+    if (total_bytes_read_ >= read_limit_)
+      return -1;
     if (read_pos_ < write_pos_) {
       uint8_t byte = buf_[read_pos_++];
       total_bytes_read_++;
@@ -64,6 +69,8 @@ class HttpStreamAdapter {
 
   /// Peek at next byte without consuming it.
   int peek() {
+    if (total_bytes_read_ >= read_limit_)
+      return -1;
     if (read_pos_ < write_pos_) {
       return buf_[read_pos_];
     }
@@ -77,12 +84,68 @@ class HttpStreamAdapter {
     return -1;
   }
 
+  /// Read up to length bytes, copying straight out of the buffer. Returns the
+  /// number read, less than length only at EOF.
+  size_t readBytes(char *buffer, size_t length) {
+    length = std::min(length, read_limit_ - std::min(read_limit_, total_bytes_read_));
+    size_t copied = 0;
+    while (copied < length) {
+      if (read_pos_ == write_pos_ && (eof_ || !fill_buffer_()))
+        break;
+      size_t n = std::min(length - copied, write_pos_ - read_pos_);
+      memcpy(buffer + copied, buf_.data() + read_pos_, n);
+      read_pos_ += n;
+      total_bytes_read_ += n;
+      copied += n;
+    }
+    return copied;
+  }
+
+  /// Makes read(), peek() and readBytes() report EOF once n more bytes have
+  /// been consumed, bounding what one document parse can pull in.
+  void setReadLimit(size_t n) { read_limit_ = total_bytes_read_ + n; }
+  void clearReadLimit() { read_limit_ = SIZE_MAX; }
+  bool readLimitReached() const { return total_bytes_read_ >= read_limit_; }
+
   /// Returns number of bytes available in buffer (does not query underlying stream).
   int available() { return static_cast<int>(write_pos_ - read_pos_); }
 
   /// Search for target string in stream. Consumes all bytes up to and including target.
   /// Returns true if found, false if EOF reached.
-  bool find(const char *target) { return findUntil(target, nullptr); }
+  /// Searches the buffered window in bulk (Boyer-Moore-Horspool) instead of reading
+  /// byte by byte, so skipping the fields schema and dataset metadata ahead of the
+  /// payload costs a few comparisons per buffer; consumed bytes count as skipped.
+  bool find(const char *target) {
+    if (!target || !*target)
+      return true;
+    const size_t len = strlen(target);
+    if (len > buf_.size() / 2)
+      return findUntil(target, nullptr);
+
+    const uint8_t *pattern = reinterpret_cast<const uint8_t *>(target);
+    uint16_t shift[256];
+    for (auto &s : shift)
+      s = static_cast<uint16_t>(len);
+    for (size_t i = 0; i + 1 < len; ++i)
+      shift[pattern[i]] = static_cast<uint16_t>(len - 1 - i);
+
+    while (true) {
+      const size_t avail = write_pos_ - read_pos_;
+      const uint8_t *window = buf_.data() + read_pos_;
+      for (size_t i = 0; i + len <= avail; i += shift[window[i + len - 1]]) {
+        if (window[i + len - 1] == pattern[len - 1] && memcmp(window + i, pattern, len - 1) == 0) {
+          skip_(i + len);
+          return true;
+        }
+      }
+      // Keep the tail that may start a match completed by the next read
+      skip_(avail - std::min(avail, len - 1));
+      if (eof_ || !fill_buffer_()) {
+        skip_(write_pos_ - read_pos_);
+        return false;
+      }
+    }
+  }
 
   /// Read bytes until terminator is found. Returns accumulated string (excluding terminator).
   std::string readStringUntil(char terminator) {
@@ -118,45 +181,72 @@ class HttpStreamAdapter {
         return false;
       char ch = static_cast<char>(c);
 
-      // Check target match
-      if (ch == target[target_match]) {
-        target_match++;
-        if (target_match == target_len)
-          return true;
-      } else {
-        if (target_match > 0) {
-          target_match = 0;
-          if (ch == target[0])
-            target_match = 1;
-        }
-      }
-
-      // Check terminator match
+      target_match = advance_match_(target, target_match, ch);
+      if (target_match == target_len)
+        return true;
       if (term_len > 0) {
-        if (ch == terminator[term_match]) {
-          term_match++;
-          if (term_match == term_len)
-            return false;  // Terminator found first
-        } else {
-          if (term_match > 0) {
-            term_match = 0;
-            if (ch == terminator[0])
-              term_match = 1;
-          }
-        }
+        term_match = advance_match_(terminator, term_match, ch);
+        if (term_match == term_len)
+          return false;  // Terminator found first
       }
     }
   }
 
   size_t getBytesRead() const { return total_bytes_read_; }
 
+  /// True when the body ended on a read error or timeout rather than completing.
+  bool isTruncated() const { return truncated_; }
+
+  /// Bytes consumed by find() without being looked at by a parser.
+  size_t getBytesSkipped() const { return skipped_bytes_; }
+
+  /// Milliseconds from construction until the first body bytes arrived (0 if none did).
+  uint32_t getFirstByteDelay() const { return first_data_time_ ? first_data_time_ - created_time_ : 0; }
+
+  /// Milliseconds spent waiting on the underlying container for body data.
+  uint32_t getReadTime() const { return read_time_ms_; }
+
   void drainBuffer() {
     read_pos_ = write_pos_;  // Discard buffered data
   }
 
  private:
+  void skip_(size_t n) {
+    read_pos_ += n;
+    total_bytes_read_ += n;
+    skipped_bytes_ += n;
+  }
+
+  /// Length of the longest prefix of pattern that ends at ch, given that the
+  /// previous matched bytes were pattern[0, matched). Falling back through the
+  /// shorter prefixes keeps overlapping patterns ("aab" in "aaab") matching.
+  static size_t advance_match_(const char *pattern, size_t matched, char ch) {
+    while (true) {
+      if (ch == pattern[matched])
+        return matched + 1;
+      if (matched == 0)
+        return 0;
+      // Retry with the longest proper prefix that is also a suffix of pattern[0, matched)
+      size_t k = matched - 1;
+      while (k > 0 && memcmp(pattern, pattern + matched - k, k) != 0)
+        --k;
+      matched = k;
+    }
+  }
+
   bool fill_buffer_() {
-    // Only compact when remaining space is less than half the buffer
+    uint32_t start = millis();
+    bool filled = read_into_buffer_();
+    read_time_ms_ += millis() - start;
+    return filled;
+  }
+
+  bool read_into_buffer_() {
+    // An empty buffer rewinds for free; otherwise only compact when remaining
+    // space is less than half the buffer. Small TCP/TLS chunks would else be
+    // read into an ever shorter tail, costing extra container reads.
+    if (read_pos_ == write_pos_)
+      read_pos_ = write_pos_ = 0;
     size_t space = buf_.size() - write_pos_;
     if (space < buf_.size() / 2 && read_pos_ > 0) {
       size_t remaining = write_pos_ - read_pos_;
@@ -179,6 +269,8 @@ class HttpStreamAdapter {
 
       switch (result) {
         case http_request::HttpReadLoopResult::DATA:
+          if (first_data_time_ == 0)
+            first_data_time_ = millis();
           write_pos_ += bytes_read;
           return true;
         case http_request::HttpReadLoopResult::COMPLETE:
@@ -191,6 +283,7 @@ class HttpStreamAdapter {
           ESP_LOGW(TAG, "fill_buffer_ %s",
                    result == http_request::HttpReadLoopResult::ERROR ? "read error" : "timeout");
           eof_ = true;
+          truncated_ = true;
           return write_pos_ > read_pos_;
       }
       // unreachable, but satisfy compiler
@@ -203,9 +296,15 @@ class HttpStreamAdapter {
   size_t read_pos_;
   size_t write_pos_;
   size_t total_bytes_read_;
+  size_t skipped_bytes_{0};
+  size_t read_limit_{SIZE_MAX};
   bool eof_;
+  bool truncated_{false};
   uint32_t timeout_ms_;
   uint32_t last_data_time_;
+  uint32_t created_time_;
+  uint32_t first_data_time_{0};
+  uint32_t read_time_ms_{0};
 };
 
 }  // namespace cwa_town_forecast
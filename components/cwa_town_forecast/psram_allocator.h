@@ -6,6 +6,8 @@
 #include "esphome/core/helpers.h"
 #include "esphome/core/log.h"
 
+#include "alloc_trace.h"
+
 namespace esphome {
 namespace cwa_town_forecast {
 
@@ -15,7 +17,8 @@ namespace cwa_town_forecast {
 // allocate() fails loudly instead of letting the container write through
 // nullptr and corrupt memory. Instances are interchangeable (deallocate() is
 // flag-independent), hence the constant equality operators std containers
-// require.
+// require. With CWA_ALLOC_TRACE defined, every allocation and free is counted
+// under AllocCategoryOf<T>.
 template<class T> struct PsramAllocator : public RAMAllocator<T> {
   PsramAllocator() = default;
   template<class U> PsramAllocator(const PsramAllocator<U> &other) : RAMAllocator<T>(other) {}
@@ -27,9 +30,19 @@ template<class T> struct PsramAllocator : public RAMAllocator<T> {
       ESP_LOGE("cwa_town_forecast", "Out of memory allocating %zu bytes", n * sizeof(T));
       abort();
     }
+#ifdef CWA_ALLOC_TRACE
+    AllocTrace::on_alloc(AllocCategoryOf<T>::value, ptr, n * sizeof(T));
+#endif
     return ptr;
   }
 
+  void deallocate(T *ptr, size_t n) {
+#ifdef CWA_ALLOC_TRACE
+    AllocTrace::on_free(AllocCategoryOf<T>::value, ptr);
+#endif
+    RAMAllocator<T>::deallocate(ptr, n);
+  }
+
   bool operator==(const PsramAllocator &) const { return true; }
   bool operator!=(const PsramAllocator &) const { return false; }
 };
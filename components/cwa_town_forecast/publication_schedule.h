@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <ctime>
+
+namespace esphome {
+namespace cwa_town_forecast {
+
+// Predicts when to fetch so each new CWA forecast issue is picked up soon
+// after it appears, instead of polling at a fixed interval. Township forecasts
+// are issued on a fixed cycle in Taiwan time (every 6 hours from 05:00) and
+// reach the Datastore some minutes late. The response names no issue time,
+// but its first slot starts within the period after the issue, which is
+// enough to tell which issue a fetch returned. The lag is learned: fetches go
+// out at the expected issue time plus the lag, an issue not served yet is
+// rechecked with a doubling backoff and the lag raised to when it showed up,
+// and an issue already there on the first try lowers the lag towards the
+// configured delay.
+//
+// Times are UTC epochs; issue times are aligned in Taiwan time.
+class PublicationSchedule {
+ public:
+  static constexpr time_t CWA_UTC_OFFSET = 8 * 3600;
+
+  // period must divide a day; offset is the first issue of the day after
+  // midnight Taiwan time; delay is the initial and minimum lag
+  void configure(uint32_t period, uint32_t offset, uint32_t delay, uint32_t jitter, uint32_t recheck) {
+    this->period_ = std::max<uint32_t>(period, 60);
+    this->offset_ = offset % this->period_;
+    this->delay_ = std::min(delay, this->period_ / 2);
+    this->jitter_ = jitter;
+    this->recheck_ = std::max<uint32_t>(recheck, 1);
+    this->lag_ = this->delay_;
+  }
+
+  uint32_t get_period() const { return this->period_; }
+  uint32_t get_offset() const { return this->offset_; }
+  uint32_t get_delay() const { return this->delay_; }
+  uint32_t get_jitter() const { return this->jitter_; }
+  uint32_t get_recheck() const { return this->recheck_; }
+  // Learned seconds from an expected issue time until the issue is served
+  uint32_t get_lag() const { return this->lag_; }
+  // Issue time of the data held; 0 before the first successful fetch
+  time_t get_held_issue() const { return this->held_issue_; }
+  // Rechecks since the next issue became due
+  uint32_t get_misses() const { return this->misses_; }
+
+  // When the next issue is expected to be served; 0 before the first fetch
+  time_t next_due() const {
+    return this->held_issue_ != 0 ? this->held_issue_ + this->period_ + this->lag_ : 0;
+  }
+
+  // Restores the state kept across deep sleep (see SleepState)
+  void restore(time_t held_issue, uint32_t lag, uint32_t misses) {
+    this->held_issue_ = held_issue;
+    this->lag_ = std::clamp(lag, this->delay_, this->period_ / 2);
+    this->misses_ = misses;
+  }
+
+  // Latest expected issue time at or before utc
+  time_t issue_at_or_before(time_t utc) const {
+    const time_t local = utc + CWA_UTC_OFFSET - this->offset_;
+    const time_t period = this->period_;
+    const time_t rem = ((local % period) + period) % period;
+    return utc - rem;
+  }
+
+  // Records a fetch completed at now that returned the issue whose first slot
+  // starts at first_slot (0 if the fetch failed) and returns the seconds
+  // until the next fetch. random spreads that over the jitter window so many
+  // devices do not hit the API in the same second.
+  uint32_t on_fetch(time_t now, time_t first_slot, uint32_t random) {
+    const time_t latest = this->issue_at_or_before(now);
+    if (first_slot != 0) {
+      // A slot starting at the issue time counts towards the previous issue
+      const time_t issue = std::min(this->issue_at_or_before(first_slot - 1), latest);
+      if (issue > this->held_issue_) {
+        if (this->held_issue_ != 0 && issue == latest) {
+          if (this->misses_ == 0) {
+            // Already there on the first try; try a bit earlier next time
+            this->lag_ = std::max(this->delay_, this->lag_ - this->lag_ / 4);
+          } else {
+            this->lag_ = std::clamp<uint32_t>(static_cast<uint32_t>(now - latest), this->delay_, this->period_ / 2);
+          }
+        }
+        this->held_issue_ = issue;
+        this->misses_ = 0;
+      }
+    }
+    time_t next;
+    if (this->held_issue_ == 0 || latest > this->held_issue_) {
+      // The latest issue is due but not served yet, or the fetch failed
+      uint64_t wait = this->recheck_;
+      if (first_slot != 0) {
+        wait <<= std::min<uint32_t>(this->misses_, 16);
+        ++this->misses_;
+      }
+      next = now + std::min<uint64_t>(wait, this->period_ / 2);
+    } else {
+      next = this->held_issue_ + this->period_ + this->lag_;
+    }
+    // An issue missed entirely is superseded by the following one
+    next = std::min<time_t>(next, latest + this->period_ + this->lag_);
+    next = std::max<time_t>(next, now + 1);
+    if (this->jitter_ > 0)
+      next += random % (this->jitter_ + 1);
+    return static_cast<uint32_t>(next - now);
+  }
+
+ protected:
+  uint32_t period_{6 * 3600};
+  uint32_t offset_{5 * 3600};
+  uint32_t delay_{600};
+  uint32_t jitter_{300};
+  uint32_t recheck_{600};
+  uint32_t lag_{600};
+  time_t held_issue_{0};
+  uint32_t misses_{0};
+};
+
+}  // namespace cwa_town_forecast
+}  // namespace esphome
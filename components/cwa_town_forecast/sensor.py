@@ -6,6 +6,11 @@ from esphome.const import (
     DEVICE_CLASS_TEMPERATURE,
     DEVICE_CLASS_HUMIDITY,
     DEVICE_CLASS_WIND_SPEED,
+    DEVICE_CLASS_DURATION,
+    DEVICE_CLASS_DATA_SIZE,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    UNIT_BYTES,
+    UNIT_MILLISECOND,
 )
 
 from . import (
@@ -32,6 +37,22 @@ CONF_MIN_TEMPERATURE = "min_temperature"
 CONF_MAX_APPARENT_TEMPERATURE = "max_apparent_temperature"
 CONF_MIN_APPARENT_TEMPERATURE = "min_apparent_temperature"
 CONF_UV_INDEX = "uv_index"
+# diagnostic sensors describing the last fetch
+CONF_CONNECT_TIME = "connect_time"
+CONF_FIRST_BYTE_TIME = "first_byte_time"
+CONF_DOWNLOAD_TIME = "download_time"
+CONF_PARSE_TIME = "parse_time"
+CONF_HASH_TIME = "hash_time"
+CONF_PUBLISH_TIME = "publish_time"
+CONF_WAKE_TO_PUBLISH_TIME = "wake_to_publish_time"
+CONF_BYTES_READ = "bytes_read"
+CONF_BYTES_SKIPPED = "bytes_skipped"
+CONF_SLOTS_PARSED = "slots_parsed"
+CONF_STRING_POOL_SIZE = "string_pool_size"
+CONF_PARSE_PEAK_HEAP = "parse_peak_heap"
+CONF_PARSE_LARGEST_FREE_BLOCK = "parse_largest_free_block"
+CONF_DROPPED_SLOTS = "dropped_slots"
+CONF_DROPPED_VALUES = "dropped_values"
 
 SENSORS_3DAYS = [
     CONF_TEMPERATURE,
@@ -55,7 +76,77 @@ SENSORS_7DAYS = [
     CONF_UV_INDEX,
 ]
 
-SENSORS = list(set(SENSORS_3DAYS + SENSORS_7DAYS))
+DIAGNOSTIC_SENSORS = [
+    CONF_CONNECT_TIME,
+    CONF_FIRST_BYTE_TIME,
+    CONF_DOWNLOAD_TIME,
+    CONF_PARSE_TIME,
+    CONF_HASH_TIME,
+    CONF_PUBLISH_TIME,
+    CONF_WAKE_TO_PUBLISH_TIME,
+    CONF_BYTES_READ,
+    CONF_BYTES_SKIPPED,
+    CONF_SLOTS_PARSED,
+    CONF_STRING_POOL_SIZE,
+    CONF_PARSE_PEAK_HEAP,
+    CONF_PARSE_LARGEST_FREE_BLOCK,
+    CONF_DROPPED_SLOTS,
+    CONF_DROPPED_VALUES,
+]
+
+SENSORS = list(set(SENSORS_3DAYS + SENSORS_7DAYS + DIAGNOSTIC_SENSORS))
+
+
+def _duration_schema(accuracy_decimals=0):
+    return sensor.sensor_schema(
+        unit_of_measurement=UNIT_MILLISECOND,
+        icon="mdi:timer-outline",
+        device_class=DEVICE_CLASS_DURATION,
+        state_class=STATE_CLASS_MEASUREMENT,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        accuracy_decimals=accuracy_decimals,
+    )
+
+
+def _bytes_schema():
+    return sensor.sensor_schema(
+        unit_of_measurement=UNIT_BYTES,
+        icon="mdi:memory",
+        device_class=DEVICE_CLASS_DATA_SIZE,
+        state_class=STATE_CLASS_MEASUREMENT,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        accuracy_decimals=0,
+    )
+
+
+def _count_schema(icon):
+    return sensor.sensor_schema(
+        icon=icon,
+        state_class=STATE_CLASS_MEASUREMENT,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        accuracy_decimals=0,
+    )
+
+
+DIAGNOSTIC_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_CONNECT_TIME): _duration_schema(),
+        cv.Optional(CONF_FIRST_BYTE_TIME): _duration_schema(),
+        cv.Optional(CONF_DOWNLOAD_TIME): _duration_schema(),
+        cv.Optional(CONF_PARSE_TIME): _duration_schema(),
+        cv.Optional(CONF_HASH_TIME): _duration_schema(accuracy_decimals=2),
+        cv.Optional(CONF_PUBLISH_TIME): _duration_schema(),
+        cv.Optional(CONF_WAKE_TO_PUBLISH_TIME): _duration_schema(),
+        cv.Optional(CONF_BYTES_READ): _bytes_schema(),
+        cv.Optional(CONF_BYTES_SKIPPED): _bytes_schema(),
+        cv.Optional(CONF_SLOTS_PARSED): _count_schema("mdi:format-list-numbered"),
+        cv.Optional(CONF_STRING_POOL_SIZE): _bytes_schema(),
+        cv.Optional(CONF_PARSE_PEAK_HEAP): _bytes_schema(),
+        cv.Optional(CONF_PARSE_LARGEST_FREE_BLOCK): _bytes_schema(),
+        cv.Optional(CONF_DROPPED_SLOTS): _count_schema("mdi:delete-clock-outline"),
+        cv.Optional(CONF_DROPPED_VALUES): _count_schema("mdi:delete-outline"),
+    }
+)
 
 
 CONFIG_SCHEMA = cv.All(
@@ -107,7 +198,9 @@ CONFIG_SCHEMA = cv.All(
                         accuracy_decimals=0,
                     ),
                 }
-            ).extend(CHILD_SCHEMA),
+            )
+            .extend(DIAGNOSTIC_SCHEMA)
+            .extend(CHILD_SCHEMA),
             MODE_SEVEN_DAYS: cv.Schema(
                 {
                     cv.Optional(CONF_TEMPERATURE): sensor.sensor_schema(
@@ -180,7 +273,9 @@ CONFIG_SCHEMA = cv.All(
                         accuracy_decimals=0,
                     ),
                 }
-            ).extend(CHILD_SCHEMA),
+            )
+            .extend(DIAGNOSTIC_SCHEMA)
+            .extend(CHILD_SCHEMA),
         },
         key=CONF_MODE,
     )
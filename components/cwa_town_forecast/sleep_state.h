@@ -0,0 +1,133 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <string>
+
+namespace esphome {
+namespace cwa_town_forecast {
+
+// What a battery device needs after deep sleep to skip a fetch, or at least
+// the work a fetch would repeat. It lives in RTC slow memory, which survives
+// deep sleep but not power loss: the hash of the last record (so on_data_change
+// only fires for new data), the response's ETag for a conditional request,
+// the publication schedule, and a snapshot of the current slot's sensor values
+// to publish right after waking. A checksum and a fingerprint of the query
+// reject memory left by a power-up, another firmware or another town.
+//
+// Snapshot entries are key:u8 length:u8 value bytes; values longer than 255
+// bytes are cut at a UTF-8 character boundary.
+struct SleepState {
+  static constexpr uint32_t MAGIC = 0x53415743;  // "CWAS"
+  static constexpr uint16_t VERSION = 1;
+  static constexpr size_t ETAG_SIZE = 64;
+  static constexpr size_t SNAPSHOT_SIZE = 768;
+  // Snapshot keys past ElementValueKey for the names
+  static constexpr uint8_t KEY_LOCATIONS_NAME = 0xFE;
+  static constexpr uint8_t KEY_LOCATION_NAME = 0xFF;
+
+  uint32_t magic;
+  uint16_t version;
+  uint16_t snapshot_used;
+  uint32_t checksum;
+  uint32_t query_hash;
+  uint64_t hash_code;
+  int64_t fetched_at;   // UTC
+  int64_t valid_until;  // UTC end of the snapshot's slot; 0 = none
+  int64_t first_slot;   // UTC first slot of the record, identifies its issue
+  int64_t held_issue;   // PublicationSchedule state
+  uint32_t lag;
+  uint32_t misses;
+  bool snapshot_complete;
+  char etag[ETAG_SIZE];
+  uint8_t snapshot[SNAPSHOT_SIZE];
+
+  bool is_valid(uint32_t query) const {
+    return this->magic == MAGIC && this->version == VERSION && this->query_hash == query &&
+           this->snapshot_used <= SNAPSHOT_SIZE && this->checksum == this->compute_checksum_();
+  }
+
+  void reset(uint32_t query) {
+    memset(this, 0, sizeof(*this));
+    this->magic = MAGIC;
+    this->version = VERSION;
+    this->query_hash = query;
+    this->snapshot_complete = true;
+  }
+
+  // Seals the state after changes; is_valid() fails until then
+  void commit() { this->checksum = this->compute_checksum_(); }
+
+  void set_etag(const std::string &value) {
+    // An ETag that does not fit is useless cut short
+    if (value.size() >= ETAG_SIZE) {
+      this->etag[0] = '\0';
+      return;
+    }
+    memcpy(this->etag, value.c_str(), value.size() + 1);
+  }
+
+  void clear_snapshot() {
+    this->snapshot_used = 0;
+    this->snapshot_complete = true;
+  }
+
+  // Appends a value; a value that does not fit marks the snapshot
+  // incomplete, so it is not published on its own
+  void add(uint8_t key, const std::string &value) {
+    size_t n = std::min<size_t>(value.size(), 255);
+    // Back up to a UTF-8 lead byte
+    while (n < value.size() && n > 0 && (static_cast<uint8_t>(value[n]) & 0xC0) == 0x80)
+      --n;
+    if (this->snapshot_used + 2 + n > SNAPSHOT_SIZE) {
+      this->snapshot_complete = false;
+      return;
+    }
+    uint8_t *p = this->snapshot + this->snapshot_used;
+    p[0] = key;
+    p[1] = static_cast<uint8_t>(n);
+    memcpy(p + 2, value.data(), n);
+    this->snapshot_used += 2 + n;
+  }
+
+  bool find(uint8_t key, std::string &value) const {
+    for (size_t pos = 0; pos + 2 <= this->snapshot_used;) {
+      const uint8_t *p = this->snapshot + pos;
+      if (pos + 2 + p[1] > this->snapshot_used)
+        break;
+      if (p[0] == key) {
+        value.assign(reinterpret_cast<const char *>(p + 2), p[1]);
+        return true;
+      }
+      pos += 2 + p[1];
+    }
+    return false;
+  }
+
+  // Whether the snapshot holds the values to show at utc
+  bool covers(time_t utc) const {
+    return this->snapshot_complete && this->snapshot_used > 0 && this->fetched_at <= utc && utc < this->valid_until;
+  }
+
+  static uint32_t fnv1a(const void *data, size_t len, uint32_t hash = 2166136261UL) {
+    const uint8_t *p = static_cast<const uint8_t *>(data);
+    for (size_t i = 0; i < len; ++i) {
+      hash ^= p[i];
+      hash *= 16777619UL;
+    }
+    return hash;
+  }
+
+ protected:
+  // Covers everything after the checksum, up to the used part of the snapshot
+  uint32_t compute_checksum_() const {
+    const uint8_t *begin = reinterpret_cast<const uint8_t *>(&this->query_hash);
+    const uint8_t *end = this->snapshot + std::min<size_t>(this->snapshot_used, SNAPSHOT_SIZE);
+    return fnv1a(begin, end - begin);
+  }
+};
+
+}  // namespace cwa_town_forecast
+}  // namespace esphome
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <limits>
 #include <vector>
 
 #include "esphome/core/log.h"
@@ -11,55 +13,273 @@
 namespace esphome {
 namespace cwa_town_forecast {
 
+// Pool buffer (char) and compaction scratch (offsets) allocations
+template<> struct AllocCategoryOf<char> {
+  static constexpr AllocCategory value = AllocCategory::STRING_POOL;
+};
+template<> struct AllocCategoryOf<uint16_t> {
+  static constexpr AllocCategory value = AllocCategory::STRING_POOL;
+};
+template<> struct AllocCategoryOf<uint32_t> {
+  static constexpr AllocCategory value = AllocCategory::STRING_POOL;
+};
+
 // Deduplicating storage for forecast element values: unique NUL-terminated
-// strings are appended to one PSRAM-preferred buffer and referenced by 16-bit
+// strings are appended to one PSRAM-preferred buffer and referenced by
 // offsets. Real CWA responses carry only ~100 unique values (a few KB) across
 // hundreds of slots, so one growing allocation replaces hundreds of per-value
 // strings and the per-slot cost shrinks to a {key, offset} pair.
 //
+// OffsetT bounds the pool size: 16-bit offsets (the default, see
+// StringPoolOffset) cap it at 64 KB, plenty for one town; 32-bit offsets lift
+// the cap for multi-town or long-retention datasets at 4 extra bytes per value
+// (a {key, offset} pair pads from 4 to 8 bytes).
+//
+// intern() finds an existing copy by walking the buffer, which is cheap for
+// one town's few KB but makes filling a large pool quadratic. 32-bit pools
+// therefore keep an open-addressed hash index of string offsets (kept at most
+// half full, so 8-16 bytes per unique string), rebuilt by assign() and
+// compacted().
+//
 // Usage rules:
 // - Pointers returned by get() are invalidated by the next intern() (the
 //   buffer may reallocate); copy the value out before interning again.
 // - Never pass a pointer obtained from get() back into intern(): inserting a
 //   range that aliases the pool's own buffer is undefined behavior.
-class StringPool {
+template<typename OffsetT> class BasicStringPool {
  public:
+  using offset_type = OffsetT;
+
   // Offset 0 is always the empty string; it doubles as the overflow fallback.
-  StringPool() {
-    data_.reserve(1024);
-    data_.push_back('\0');
-  }
+  BasicStringPool() : BasicStringPool(1024) {}
 
-  const char *get(uint16_t offset) const { return offset < data_.size() ? data_.data() + offset : ""; }
+  const char *get(OffsetT offset) const { return offset < data_.size() ? data_.data() + offset : ""; }
 
   // Returns the offset of str, appending it if not seen before.
-  uint16_t intern(const char *str) {
+  OffsetT intern(const char *str) {
+    OffsetT off = this->intern(str, this->limit_);
+    if (off == 0 && str != nullptr && str[0] != '\0')
+      ESP_LOGW("cwa_town_forecast", "String pool full (%zu bytes), dropping value: %s", data_.size(), str);
+    return off;
+  }
+
+  // As intern(), but a new string is only appended while the pool stays
+  // within limit bytes (capped by set_limit()); refusals return 0 and count
+  // as dropped.
+  OffsetT intern(const char *str, size_t limit) {
     if (str == nullptr || str[0] == '\0')
       return 0;
     const size_t len = strlen(str);
-    size_t off = 0;
-    while (off < data_.size()) {
-      const char *entry = data_.data() + off;
-      const size_t entry_len = strlen(entry);
-      if (entry_len == len && memcmp(entry, str, len) == 0)
-        return static_cast<uint16_t>(off);
-      off += entry_len + 1;
-    }
-    if (data_.size() + len + 1 > MAX_SIZE) {
-      ESP_LOGW("cwa_town_forecast", "String pool full (%zu bytes), dropping value: %s", data_.size(), str);
+    const OffsetT existing = this->find_(str, len);
+    if (existing != 0)
+      return existing;
+    if (data_.size() + len + 1 > std::min(limit, this->limit_)) {
+      ++this->dropped_values_;
       return 0;
     }
-    const uint16_t new_off = static_cast<uint16_t>(data_.size());
+    const OffsetT new_off = static_cast<OffsetT>(data_.size());
     data_.insert(data_.end(), str, str + len + 1);
+    if constexpr (INDEXED)
+      this->index_add_(new_off);
     return new_off;
   }
 
   size_t size() const { return data_.size(); }
+  // The raw buffer: size() bytes of NUL-terminated strings, offset 0 first.
+  const char *data() const { return data_.data(); }
+
+  // Replaces the contents with size bytes that read(char *dst, size_t n)
+  // fills in, e.g. a pool serialized from data(). Rejects (leaving the pool
+  // empty) a short read or bytes that do not form a pool: a leading empty
+  // string and a NUL-terminated last string, within the offset range.
+  template<typename ReadFn> bool assign(size_t size, ReadFn read) {
+    if (size == 0 || size > this->limit_) {
+      this->clear();
+      return false;
+    }
+    data_.resize(size);
+    if (!read(data_.data(), size) || data_.front() != '\0' || data_.back() != '\0') {
+      this->clear();
+      return false;
+    }
+    this->dropped_values_ = 0;
+    if constexpr (INDEXED)
+      this->rebuild_index_(0);
+    return true;
+  }
+
+  // Whether offset refers to the start of a string (as intern() returns).
+  bool is_string_start(OffsetT offset) const {
+    return offset == 0 || (offset < data_.size() && data_[offset - 1] == '\0');
+  }
+
+  // Caps the pool at limit bytes (0 lifts the cap to the offset range) and
+  // reserves a capped pool's whole buffer up front so it never grows.
+  void set_limit(size_t limit) {
+    this->limit_ = (limit == 0 || limit > MAX_SIZE) ? MAX_SIZE : limit;
+    if (this->limit_ < MAX_SIZE)
+      data_.reserve(this->limit_);
+  }
+
+  // Drops every string but keeps the buffer's capacity for the next parse.
+  void clear() {
+    data_.clear();
+    data_.push_back('\0');
+    this->dropped_values_ = 0;
+    if constexpr (INDEXED) {
+      std::fill(this->index_.begin(), this->index_.end(), 0);
+      this->index_count_ = 0;
+    }
+  }
+
+  // Values intern() refused because the pool was full (they read back as "").
+  uint32_t dropped_values() const { return this->dropped_values_; }
+
+  // Bytes held by strings that no live offset references. for_each_offset(fn)
+  // must call fn with every live offset (see compacted()).
+  template<typename ForEachOffset> size_t wasted_bytes(ForEachOffset for_each_offset) const {
+    std::vector<OffsetT, PsramAllocator<OffsetT>> live = collect_live_(for_each_offset);
+    size_t live_bytes = 1;  // the shared empty string at offset 0
+    for (OffsetT off : live)
+      live_bytes += strlen(data_.data() + off) + 1;
+    return data_.size() > live_bytes ? data_.size() - live_bytes : 0;
+  }
+
+  // Builds a new pool holding only the strings still referenced and rewrites
+  // every live offset to point into it. for_each_offset(fn) must call
+  // fn(OffsetT &) once per live offset; it is invoked twice (collect, then
+  // remap). This pool is left untouched, so Time copies that still share it
+  // keep reading their original values.
+  template<typename ForEachOffset> BasicStringPool compacted(ForEachOffset for_each_offset) const {
+    std::vector<OffsetT, PsramAllocator<OffsetT>> live = collect_live_(for_each_offset);
+    std::vector<OffsetT, PsramAllocator<OffsetT>> remap;
+    remap.reserve(live.size());
+
+    size_t live_bytes = 1;
+    for (OffsetT off : live)
+      live_bytes += strlen(data_.data() + off) + 1;
+    BasicStringPool out(live_bytes);
+    for (OffsetT off : live) {
+      const char *str = data_.data() + off;
+      remap.push_back(static_cast<OffsetT>(out.data_.size()));
+      out.data_.insert(out.data_.end(), str, str + strlen(str) + 1);
+    }
+
+    for_each_offset([&](OffsetT &off) {
+      auto it = std::lower_bound(live.begin(), live.end(), off);
+      off = (it != live.end() && *it == off) ? remap[it - live.begin()] : 0;
+    });
+    out.dropped_values_ = this->dropped_values_;
+    if constexpr (INDEXED)
+      out.rebuild_index_(0);
+    return out;
+  }
 
  private:
-  static constexpr size_t MAX_SIZE = 0xFFFF;
+  static constexpr size_t MAX_SIZE = std::numeric_limits<OffsetT>::max();
+  static constexpr bool INDEXED = sizeof(OffsetT) >= sizeof(uint32_t);
+  static constexpr size_t INDEX_MIN_SLOTS = 64;
+
+  explicit BasicStringPool(size_t reserve) {
+    data_.reserve(reserve);
+    data_.push_back('\0');
+  }
+
+  // Sorted, deduplicated non-empty offsets that point at a string start.
+  template<typename ForEachOffset>
+  std::vector<OffsetT, PsramAllocator<OffsetT>> collect_live_(ForEachOffset for_each_offset) const {
+    std::vector<OffsetT, PsramAllocator<OffsetT>> live;
+    for_each_offset([&](OffsetT off) {
+      if (off != 0 && off < data_.size() && data_[off - 1] == '\0')
+        live.push_back(off);
+    });
+    std::sort(live.begin(), live.end());
+    live.erase(std::unique(live.begin(), live.end()), live.end());
+    return live;
+  }
+
+  // Offset of a copy of str (len bytes) already in the pool, 0 if none
+  OffsetT find_(const char *str, size_t len) const {
+    if constexpr (INDEXED) {
+      if (this->index_.empty())
+        return 0;
+      const size_t mask = this->index_.size() - 1;
+      for (size_t i = hash_(str) & mask;; i = (i + 1) & mask) {
+        const OffsetT off = this->index_[i];
+        if (off == 0 || strcmp(data_.data() + off, str) == 0)
+          return off;
+      }
+    } else {
+      size_t off = 0;
+      while (off < data_.size()) {
+        const char *entry = data_.data() + off;
+        const size_t entry_len = strlen(entry);
+        if (entry_len == len && memcmp(entry, str, len) == 0)
+          return static_cast<OffsetT>(off);
+        off += entry_len + 1;
+      }
+      return 0;
+    }
+  }
+
+  // FNV-1a
+  static uint32_t hash_(const char *str) {
+    uint32_t h = 2166136261u;
+    for (; *str != '\0'; ++str)
+      h = (h ^ static_cast<uint8_t>(*str)) * 16777619u;
+    return h;
+  }
+
+  // Indexes the string just appended at off, doubling the table first when it
+  // would become more than half full
+  void index_add_(OffsetT off) {
+    if ((this->index_count_ + 1) * 2 > this->index_.size()) {
+      this->rebuild_index_(this->index_.size() * 2);  // picks up off too
+      return;
+    }
+    this->index_put_(off);
+  }
+
+  void index_put_(OffsetT off) {
+    const size_t mask = this->index_.size() - 1;
+    size_t i = hash_(data_.data() + off) & mask;
+    while (this->index_[i] != 0)
+      i = (i + 1) & mask;
+    this->index_[i] = off;
+    ++this->index_count_;
+  }
+
+  // Re-indexes every string in the buffer into at least min_slots slots
+  void rebuild_index_(size_t min_slots) {
+    size_t count = 0;
+    for (size_t off = 1; off < data_.size(); off += strlen(data_.data() + off) + 1)
+      ++count;
+    size_t slots = INDEX_MIN_SLOTS;
+    while (slots < min_slots || slots < count * 2)
+      slots *= 2;
+    this->index_.assign(slots, 0);
+    this->index_count_ = 0;
+    for (size_t off = 1; off < data_.size(); off += strlen(data_.data() + off) + 1)
+      this->index_put_(static_cast<OffsetT>(off));
+  }
+
   std::vector<char, PsramAllocator<char>> data_;
+  size_t limit_{MAX_SIZE};
+  uint32_t dropped_values_{0};
+  // Only used when INDEXED: string offsets by hash, 0 marking a free slot
+  std::vector<OffsetT, PsramAllocator<OffsetT>> index_;
+  size_t index_count_{0};
 };
 
+// Offset width used by Record storage. CWA_LARGE_STRING_POOL (set by the
+// large_string_pool option) switches to 32-bit offsets.
+#ifdef CWA_LARGE_STRING_POOL
+using StringPoolOffset = uint32_t;
+#else
+using StringPoolOffset = uint16_t;
+#endif
+
+using StringPool = BasicStringPool<StringPoolOffset>;
+
 }  // namespace cwa_town_forecast
 }  // namespace esphome
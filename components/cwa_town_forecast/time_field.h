@@ -15,14 +15,19 @@ namespace cwa_town_forecast {
 // local wall times, so one fixed TZ-independent convention on both sides
 // compares correctly and round-trips losslessly — matching the previous
 // mktime-on-both-sides behavior where any TZ offset cancelled out.
+//
+// Storage is a 32-bit delta from 2000-01-01 00:00:00 (wall), so each Time's
+// three fields take 12 bytes instead of 24 while keeping second precision;
+// the API still speaks full time_t epochs. Times outside 2000..2136 cannot be
+// represented and are stored as invalid.
 class TimeField {
  public:
   TimeField() = default;
   TimeField(const std::tm &tm) { *this = tm; }
-  explicit TimeField(time_t wall_epoch) : epoch_(wall_epoch) {}
+  explicit TimeField(time_t wall_epoch) : delta_(encode_(wall_epoch)) {}
 
   TimeField &operator=(const std::tm &tm) {
-    this->epoch_ = to_wall_epoch(tm);
+    this->delta_ = encode_(to_wall_epoch(tm));
     return *this;
   }
 
@@ -37,31 +42,61 @@ class TimeField {
     int64_t mon = tm.tm_mon;
     int64_t y = static_cast<int64_t>(tm.tm_year) + 1900 + (mon >= 0 ? mon / 12 : (mon - 11) / 12);
     mon = ((mon % 12) + 12) % 12;
-    const unsigned m = static_cast<unsigned>(mon + 1);
-    // days_from_civil for the 1st of the month (proleptic Gregorian), then
-    // add day/time offsets so out-of-range tm_mday/hour/min/sec normalize
-    y -= m <= 2;
-    const int64_t era = (y >= 0 ? y : y - 399) / 400;
-    const unsigned yoe = static_cast<unsigned>(y - era * 400);
-    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5;
-    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
-    const int64_t days = era * 146097 + static_cast<int64_t>(doe) - 719468 + (tm.tm_mday - 1);
+    // Day/time offsets added after the 1st of the month so out-of-range
+    // tm_mday/hour/min/sec normalize
+    const int64_t days = days_from_civil(y, static_cast<unsigned>(mon + 1)) + (tm.tm_mday - 1);
     return static_cast<time_t>(days * 86400 + tm.tm_hour * 3600LL + tm.tm_min * 60LL + tm.tm_sec);
   }
 
-  bool is_valid() const { return this->epoch_ != INVALID_EPOCH; }
+  // Fixed-position parse of "YYYY-MM-DDTHH:MM:SS" with an optional "+HH:MM",
+  // "-HH:MM" or "Z" suffix, or a bare "YYYY-MM-DD", straight to a wall epoch.
+  // A suffix other than +08:00 is converted to Taiwan wall time, the
+  // convention every TimeField uses. Returns false for anything else (other
+  // layouts, out-of-range fields) so callers can fall back to a lenient parse.
+  static bool parse_iso8601(const char *s, time_t &wall_epoch) {
+    int year, month, day, hour = 0, min = 0, sec = 0;
+    if (!digits_(s, 4, year) || s[4] != '-' || !digits_(s + 5, 2, month) || s[7] != '-' || !digits_(s + 8, 2, day))
+      return false;
+    int64_t offset_seconds = CWA_UTC_OFFSET_SECONDS;
+    const char *p = s + 10;
+    if (*p == 'T') {
+      if (!digits_(p + 1, 2, hour) || p[3] != ':' || !digits_(p + 4, 2, min) || p[6] != ':' || !digits_(p + 7, 2, sec))
+        return false;
+      p += 9;
+      if (*p == 'Z') {
+        offset_seconds = 0;
+        ++p;
+      } else if (*p == '+' || *p == '-') {
+        int off_h, off_m;
+        if (!digits_(p + 1, 2, off_h) || p[3] != ':' || !digits_(p + 4, 2, off_m))
+          return false;
+        offset_seconds = (*p == '-' ? -1 : 1) * (off_h * 3600LL + off_m * 60LL);
+        p += 6;
+      }
+    }
+    if (*p != '\0' || month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || min > 59 || sec > 60)
+      return false;
+    const int64_t days = days_from_civil(year, static_cast<unsigned>(month)) + (day - 1);
+    wall_epoch = static_cast<time_t>(days * 86400 + hour * 3600LL + min * 60LL + sec + CWA_UTC_OFFSET_SECONDS -
+                                     offset_seconds);
+    return true;
+  }
+
+  bool is_valid() const { return this->delta_ != INVALID_DELTA; }
   operator bool() const { return this->is_valid(); }
 
   // Wall-clock seconds; only meaningful for comparison/difference against
   // values produced by to_wall_epoch() with the same convention.
-  time_t epoch() const { return this->epoch_; }
+  time_t epoch() const {
+    return this->is_valid() ? static_cast<time_t>(BASE_EPOCH + this->delta_) : std::numeric_limits<time_t>::min();
+  }
 
   std::tm to_tm() const {
     std::tm tm{};
     if (this->is_valid()) {
       // gmtime_r is TZ-independent, so it inverts the wall-epoch convention
       // exactly (and fills tm_wday/tm_yday correctly)
-      time_t e = this->epoch_;
+      time_t e = this->epoch();
       gmtime_r(&e, &tm);
     }
     return tm;
@@ -69,11 +104,46 @@ class TimeField {
 
   operator std::tm() const { return this->to_tm(); }
 
-  void reset() { this->epoch_ = INVALID_EPOCH; }
+  void reset() { this->delta_ = INVALID_DELTA; }
 
  private:
-  static constexpr time_t INVALID_EPOCH = std::numeric_limits<time_t>::min();
-  time_t epoch_{INVALID_EPOCH};
+  // CWA publishes Taiwan times (UTC+8, no DST)
+  static constexpr int64_t CWA_UTC_OFFSET_SECONDS = 8 * 3600;
+
+  // Days from 1970-01-01 to the 1st of month m (1-12) of year y, proleptic
+  // Gregorian (Hinnant's days_from_civil)
+  static int64_t days_from_civil(int64_t y, unsigned m) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+  }
+
+  // Reads exactly n ASCII digits; stops at (and rejects) a NUL or non-digit
+  static bool digits_(const char *s, int n, int &out) {
+    int v = 0;
+    for (int i = 0; i < n; ++i) {
+      const unsigned d = static_cast<unsigned char>(s[i]) - '0';
+      if (d > 9)
+        return false;
+      v = v * 10 + static_cast<int>(d);
+    }
+    out = v;
+    return true;
+  }
+
+  // 2000-01-01 00:00:00 as a wall epoch
+  static constexpr int64_t BASE_EPOCH = 946684800;
+  static constexpr uint32_t INVALID_DELTA = std::numeric_limits<uint32_t>::max();
+
+  static uint32_t encode_(time_t wall_epoch) {
+    const int64_t delta = static_cast<int64_t>(wall_epoch) - BASE_EPOCH;
+    return (delta < 0 || delta >= INVALID_DELTA) ? INVALID_DELTA : static_cast<uint32_t>(delta);
+  }
+
+  uint32_t delta_{INVALID_DELTA};
 };
 
 }  // namespace cwa_town_forecast
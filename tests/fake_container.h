@@ -0,0 +1,94 @@
+#pragma once
+
+// An HttpContainer serving a body the way a real connection does: in chunks
+// of random size, with runs of empty reads (RETRY), stalls and read errors.
+// Stalls run on the virtual clock, so a 10 s timeout costs no wall time.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+
+#include "esphome/components/http_request/http_request.h"
+
+namespace cwa_test {
+
+struct Chunking {
+  size_t min_chunk{1};
+  size_t max_chunk{1460};
+  // Chance that a read starts a run of up to max_retries empty reads
+  double retry_chance{0};
+  size_t max_retries{0};
+  // Once stall_at bytes have been served, reads return 0 for stall_ms
+  size_t stall_at{SIZE_MAX};
+  uint32_t stall_ms{0};
+  // Once error_at bytes have been served, reads fail
+  size_t error_at{SIZE_MAX};
+};
+
+class FakeContainer : public esphome::http_request::HttpContainer {
+ public:
+  FakeContainer(std::string body, Chunking chunking, uint32_t seed)
+      : body_(std::move(body)), chunking_(chunking), rng_(seed) {
+    this->content_length = this->body_.size();
+    this->status_code = 200;
+    this->duration_ms = 0;
+  }
+
+  int read(uint8_t *buf, size_t max_len) override {
+    ++this->reads_;
+    this->min_offered_ = std::min(this->min_offered_, max_len);
+    if (this->pending_retries_ > 0) {
+      --this->pending_retries_;
+      return 0;
+    }
+    if (this->bytes_read_ >= this->chunking_.stall_at && this->stall_end_ == 0)
+      this->stall_end_ = esphome::millis() + this->chunking_.stall_ms;
+    if (this->stall_end_ != 0 && esphome::millis() < this->stall_end_)
+      return 0;
+    if (this->bytes_read_ >= this->chunking_.error_at)
+      return -1;
+    if (this->chunking_.retry_chance > 0 && this->chance_() < this->chunking_.retry_chance) {
+      this->pending_retries_ = this->below_(this->chunking_.max_retries);
+      return 0;
+    }
+
+    size_t n = this->chunking_.min_chunk +
+               this->below_(this->chunking_.max_chunk - this->chunking_.min_chunk + 1);
+    n = std::min({n, max_len, this->body_.size() - this->bytes_read_});
+    // Stop at a stall or error point, so it hits exactly there
+    for (size_t mark : {this->chunking_.stall_at, this->chunking_.error_at}) {
+      if (this->bytes_read_ < mark)
+        n = std::min(n, mark - this->bytes_read_);
+    }
+    memcpy(buf, this->body_.data() + this->bytes_read_, n);
+    this->bytes_read_ += n;
+    this->data_reads_ += n > 0;
+    return static_cast<int>(n);
+  }
+
+  void end() override {}
+
+  // Calls to read(), and those of them that returned data
+  size_t reads() const { return this->reads_; }
+  size_t data_reads() const { return this->data_reads_; }
+  // Smallest max_len a caller offered
+  size_t min_offered() const { return this->min_offered_; }
+
+ protected:
+  size_t below_(size_t n) { return n == 0 ? 0 : std::uniform_int_distribution<size_t>(0, n - 1)(this->rng_); }
+  double chance_() { return std::uniform_real_distribution<double>(0, 1)(this->rng_); }
+
+  std::string body_;
+  Chunking chunking_;
+  std::mt19937 rng_;
+  size_t pending_retries_{0};
+  uint32_t stall_end_{0};
+  size_t reads_{0};
+  size_t data_reads_{0};
+  size_t min_offered_{SIZE_MAX};
+};
+
+}  // namespace cwa_test
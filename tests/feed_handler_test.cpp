@@ -0,0 +1,60 @@
+// FeedHandler on the stand-in web server, whose request URL is an Arduino
+// String as on ESPAsyncWebServer: path matching, the 503 before the first
+// feed, and serving the latest feed published.
+
+#include <cstdio>
+#include <memory>
+
+#include "forecast_feed.h"
+
+using esphome::cwa_town_forecast::FeedBuffer;
+using esphome::cwa_town_forecast::FeedHandler;
+using esphome::web_server_idf::AsyncWebServerRequest;
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+      ++failures; \
+    } \
+  } while (0)
+
+AsyncWebServerRequest request_for(const char *url) {
+  AsyncWebServerRequest request;
+  request.url_ = url;
+  return request;
+}
+
+}  // namespace
+
+int main() {
+  FeedHandler handler;
+  handler.set_path("/cwa/feed");
+
+  AsyncWebServerRequest feed = request_for("/cwa/feed");
+  AsyncWebServerRequest other = request_for("/cwa/feed2");
+  AsyncWebServerRequest prefix = request_for("/cwa");
+  CHECK(handler.canHandle(&feed));
+  CHECK(!handler.canHandle(&other));
+  CHECK(!handler.canHandle(&prefix));
+
+  handler.handleRequest(&feed);
+  CHECK(feed.code_ == 503);
+
+  for (uint8_t version = 1; version <= 2; ++version) {
+    auto buffer = std::make_shared<FeedBuffer>();
+    buffer->assign({'C', 'W', 'A', 'F', version});
+    handler.publish(buffer);
+    AsyncWebServerRequest request = request_for("/cwa/feed");
+    handler.handleRequest(&request);
+    CHECK(request.code_ == 200);
+    CHECK(request.body_ == std::string(buffer->begin(), buffer->end()));
+  }
+
+  printf(failures == 0 ? "PASS\n" : "%d FAILURES\n", failures);
+  return failures == 0 ? 0 : 1;
+}
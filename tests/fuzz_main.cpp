@@ -0,0 +1,37 @@
+// Replays fuzz inputs through LLVMFuzzerTestOneInput() where libFuzzer is not
+// available: each argument is a file or a directory of files.
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "parse_harness.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+int main(int argc, char **argv) {
+  std::vector<std::filesystem::path> inputs;
+  for (int i = 1; i < argc; ++i) {
+    const std::filesystem::path path(argv[i]);
+    if (std::filesystem::is_directory(path)) {
+      for (const auto &entry : std::filesystem::directory_iterator(path)) {
+        if (entry.is_regular_file())
+          inputs.push_back(entry.path());
+      }
+    } else {
+      inputs.push_back(path);
+    }
+  }
+  if (inputs.empty()) {
+    fprintf(stderr, "usage: %s <file or directory>...\n", argv[0]);
+    return 2;
+  }
+  for (const auto &input : inputs) {
+    const std::string data = cwa_test::read_file(input.string());
+    LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t *>(data.data()), data.size());
+  }
+  printf("Ran %zu inputs\n", inputs.size());
+  return 0;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+// Deterministic mutations of a CWA response, modelled on what a flaky
+// network, a truncating proxy or an API change could hand the parser.
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+
+namespace cwa_test {
+
+enum class Mutation : uint8_t {
+  TRUNCATE,      // cut off anywhere
+  FLIP,          // overwrite a few bytes with structural characters
+  HUGE_RUN,      // insert up to 64 KB of junk anywhere
+  HUGE_STRING,   // lengthen a string value by up to 64 KB
+  EXTRA_KEYS,    // add unknown keys and nested values
+  UNQUOTE,       // a value as a bare number or literal instead of a string
+  REORDER,       // move an object ahead of its predecessor
+  COUNT,
+};
+
+inline const char *mutation_name(Mutation mutation) {
+  static const char *const NAMES[] = {"truncate", "flip",    "huge_run", "huge_string",
+                                      "extra_keys", "unquote", "reorder"};
+  return NAMES[static_cast<size_t>(mutation)];
+}
+
+class Mutator {
+ public:
+  explicit Mutator(uint32_t seed) : rng_(seed) {}
+
+  // Applies mutation to body; returns false when the payload has nothing it
+  // applies to (body is then unchanged)
+  bool apply(Mutation mutation, std::string &body) {
+    if (body.empty())
+      return false;
+    switch (mutation) {
+      case Mutation::TRUNCATE:
+        body.resize(this->below_(body.size()));
+        return true;
+      case Mutation::FLIP: {
+        static const char STRUCTURAL[] = "{}[],:\"0a \\";
+        for (size_t i = 0, n = 1 + this->below_(8); i < n; ++i)
+          body[this->below_(body.size())] = STRUCTURAL[this->below_(sizeof(STRUCTURAL) - 1)];
+        return true;
+      }
+      case Mutation::HUGE_RUN:
+        body.insert(this->below_(body.size()), std::string(1 + this->below_(64 * 1024), 'x'));
+        return true;
+      case Mutation::HUGE_STRING: {
+        const size_t pos = body.find("\":\"", this->below_(body.size()));
+        if (pos == std::string::npos)
+          return false;
+        body.insert(pos + 3, std::string(1 + this->below_(64 * 1024), "a\xe4\xb8\xad"[this->below_(4)]));
+        return true;
+      }
+      case Mutation::EXTRA_KEYS: {
+        static const char *const EXTRAS[] = {
+            "\"Extra\":{\"a\":[1,2,{\"b\":\"c\"}],\"d\":null},",
+            "\"Note\":\"\",",
+            "\"Deep\":[[[[[[[[[[[[[[[[[[[[1]]]]]]]]]]]]]]]]]]]],",
+        };
+        const size_t pos = body.find("{\"", this->below_(body.size()));
+        if (pos == std::string::npos)
+          return false;
+        body.insert(pos + 1, EXTRAS[this->below_(3)]);
+        return true;
+      }
+      case Mutation::UNQUOTE: {
+        const size_t pos = body.find("\":\"", this->below_(body.size()));
+        if (pos == std::string::npos)
+          return false;
+        const size_t end = body.find('"', pos + 3);
+        if (end == std::string::npos)
+          return false;
+        static const char *const BARE[] = {"12.5", "-3", "1e999", "true", "null", "0x1F"};
+        body.replace(pos + 2, end - pos - 1, BARE[this->below_(6)]);
+        return true;
+      }
+      case Mutation::REORDER: {
+        const size_t first = body.find("{\"", this->below_(body.size()));
+        const size_t second = first == std::string::npos ? first : body.find("{\"", first + 2);
+        if (second == std::string::npos)
+          return false;
+        const size_t end = body.find('}', second);
+        if (end == std::string::npos)
+          return false;
+        const std::string moved = body.substr(second, end - second + 1);
+        body.erase(second, end - second + 1);
+        body.insert(first, moved + ",");
+        return true;
+      }
+      case Mutation::COUNT:
+        break;
+    }
+    return false;
+  }
+
+  Mutation pick() { return static_cast<Mutation>(this->below_(static_cast<size_t>(Mutation::COUNT))); }
+
+ protected:
+  size_t below_(size_t n) { return n == 0 ? 0 : std::uniform_int_distribution<size_t>(0, n - 1)(this->rng_); }
+
+  std::mt19937 rng_;
+};
+
+}  // namespace cwa_test
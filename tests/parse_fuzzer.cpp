@@ -0,0 +1,20 @@
+// libFuzzer target for CWATownForecast::parse_to_record(). The first input
+// byte picks the mode ('7' for 7-DAYS, anything else 3-DAYS), the rest is the
+// response body. One component instance serves every input, so the recycled
+// record slot is exercised as on a device that keeps polling.
+//
+// Without libFuzzer (CWA_FUZZ off) fuzz_main.cpp runs the corpus through it.
+
+#include <cstddef>
+#include <cstdint>
+
+#include "parse_harness.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  static cwa_test::ParseHarness harness;
+  if (size == 0)
+    return 0;
+  const auto mode = data[0] == '7' ? cwa_test::Mode::SEVEN_DAYS : cwa_test::Mode::THREE_DAYS;
+  harness.parse(data + 1, size - 1, mode);
+  return 0;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+// Drives CWATownForecast's response parser on the host: a response body goes
+// through an HttpStreamAdapter into the inactive record, as process_response_()
+// does on the device.
+
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "cwa_town_forecast.h"
+
+namespace cwa_test {
+
+using esphome::cwa_town_forecast::BufferContainer;
+using esphome::cwa_town_forecast::CWATownForecast;
+using esphome::cwa_town_forecast::HttpStreamAdapter;
+using esphome::cwa_town_forecast::Mode;
+using esphome::cwa_town_forecast::Record;
+
+struct ParseResult {
+  bool ok;
+  size_t elements;
+  size_t slots;
+  uint64_t hash_code;
+};
+
+class ParseHarness : public CWATownForecast {
+ public:
+  ParseHarness() {
+    this->set_time(&this->rtc_clock_);
+    this->set_retain_fetched_data(true);
+  }
+
+  // Parses body in mode, then empties the record again for the next call
+  ParseResult parse(const uint8_t *body, size_t size, Mode mode,
+                    std::shared_ptr<esphome::http_request::HttpContainer> container = nullptr,
+                    size_t buffer_size = HttpStreamAdapter::DEFAULT_BUFFER_SIZE) {
+    this->set_mode(mode);
+    if (container == nullptr)
+      container = std::make_shared<BufferContainer>(body, size);
+    HttpStreamAdapter stream(container, buffer_size);
+    Record &record = this->inactive_record_();
+    ParseResult result{};
+    result.ok = this->parse_to_record(stream, record, result.hash_code);
+    result.elements = record.weather_elements.size();
+    for (const auto &we : record.weather_elements)
+      result.slots += we.times.size();
+    this->clear_record_(record);
+    return result;
+  }
+
+  ParseResult parse(const std::string &body, Mode mode) {
+    return this->parse(reinterpret_cast<const uint8_t *>(body.data()), body.size(), mode);
+  }
+
+ protected:
+  esphome::time::RealTimeClock rtc_clock_;
+};
+
+inline std::string read_file(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  std::stringstream ss;
+  ss << file.rdbuf();
+  return ss.str();
+}
+
+// Drops the whitespace between JSON tokens, as the API serves it
+inline std::string compact_json(const std::string &json) {
+  std::string out;
+  out.reserve(json.size());
+  bool in_string = false, escaped = false;
+  for (char c : json) {
+    if (in_string) {
+      out += c;
+      if (escaped) {
+        escaped = false;
+      } else if (c == '\\') {
+        escaped = true;
+      } else if (c == '"') {
+        in_string = false;
+      }
+    } else if (c == '"') {
+      in_string = true;
+      out += c;
+    } else if (!isspace(static_cast<unsigned char>(c))) {
+      out += c;
+    }
+  }
+  return out;
+}
+
+}  // namespace cwa_test
@@ -0,0 +1,184 @@
+// Throughput and robustness suite for parse_to_record(): parses the
+// resources/ payloads, then seeded mutations of them (see mutator.h), and
+// fails when a case
+// - takes more than TIME_FACTOR times the clean payload's time per byte,
+// - raises the heap more than MEMORY_FACTOR times the clean payload's peak,
+// - or parses successfully although it was truncated.
+// Crashes and memory errors are left to the sanitizers.
+//
+// Usage: parse_throughput [--resources DIR] [--cases N] [--seed S] [--dump DIR]
+// --dump writes every case as a parse_fuzzer input, to seed libFuzzer.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "mutator.h"
+#include "parse_harness.h"
+
+using cwa_test::Mode;
+using cwa_test::Mutation;
+
+namespace {
+
+constexpr double TIME_FACTOR = 8.0;
+// Fixed per-parse cost (stream buffer, slot document) that small inputs
+// cannot amortize
+constexpr double TIME_ALLOWANCE_NS = 2e6;
+constexpr double MEMORY_FACTOR = 1.5;
+constexpr size_t MEMORY_ALLOWANCE = 16 * 1024;
+
+struct Payload {
+  const char *file;
+  Mode mode;
+};
+
+const Payload PAYLOADS[] = {
+    {"town_forecast_api_3d_full.json", Mode::THREE_DAYS},
+    {"town_forecast_api_7d_full.json", Mode::SEVEN_DAYS},
+    {"town_forecast_api_3d_simplified.json", Mode::THREE_DAYS},
+    {"town_forecast_api_7d_simplified.json", Mode::SEVEN_DAYS},
+};
+
+struct Measurement {
+  cwa_test::ParseResult result;
+  double ns;
+  size_t peak_bytes;
+};
+
+Measurement measure(cwa_test::ParseHarness &harness, const std::string &body, Mode mode) {
+  esphome::host_heap_reset_peak();
+  const size_t live_before = esphome::host_heap_live();
+  const auto start = std::chrono::steady_clock::now();
+  Measurement m;
+  m.result = harness.parse(body, mode);
+  m.ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  m.peak_bytes = esphome::host_heap_peak() - live_before;
+  return m;
+}
+
+// Best of a few runs, so a scheduling hiccup does not fail the suite
+Measurement measure_best(cwa_test::ParseHarness &harness, const std::string &body, Mode mode, int runs) {
+  Measurement best = measure(harness, body, mode);
+  for (int i = 1; i < runs; ++i) {
+    Measurement m = measure(harness, body, mode);
+    best.ns = std::min(best.ns, m.ns);
+  }
+  return best;
+}
+
+struct KindStats {
+  size_t cases{0};
+  size_t parsed{0};
+  double worst_ns_per_byte{0};
+  size_t worst_peak{0};
+};
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  std::string resources = CWA_RESOURCES_DIR;
+  std::string dump_dir;
+  size_t cases = 300;
+  uint32_t seed = 1;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (strcmp(argv[i], "--resources") == 0) {
+      resources = argv[i + 1];
+    } else if (strcmp(argv[i], "--cases") == 0) {
+      cases = strtoul(argv[i + 1], nullptr, 10);
+    } else if (strcmp(argv[i], "--seed") == 0) {
+      seed = strtoul(argv[i + 1], nullptr, 10);
+    } else if (strcmp(argv[i], "--dump") == 0) {
+      dump_dir = argv[i + 1];
+      std::filesystem::create_directories(dump_dir);
+    }
+  }
+
+  cwa_test::ParseHarness harness;
+  cwa_test::Mutator mutator(seed);
+  KindStats stats[static_cast<size_t>(Mutation::COUNT)];
+  int failures = 0;
+
+  for (const Payload &payload : PAYLOADS) {
+    const std::string pretty = cwa_test::read_file(resources + "/" + payload.file);
+    if (pretty.empty()) {
+      printf("FAIL %s: cannot read\n", payload.file);
+      return 1;
+    }
+    const std::string compact = cwa_test::compact_json(pretty);
+
+    // Clean payloads: both forms parse to the same record
+    const Measurement clean = measure_best(harness, compact, payload.mode, 5);
+    const Measurement clean_pretty = measure(harness, pretty, payload.mode);
+    if (!clean.result.ok || !clean_pretty.result.ok || clean.result.slots != clean_pretty.result.slots ||
+        clean.result.hash_code != clean_pretty.result.hash_code) {
+      printf("FAIL %s: clean payload (compact ok=%d slots=%zu, pretty ok=%d slots=%zu)\n", payload.file,
+             clean.result.ok, clean.result.slots, clean_pretty.result.ok, clean_pretty.result.slots);
+      ++failures;
+      continue;
+    }
+    const double ns_per_byte = clean.ns / compact.size();
+    const size_t peak_limit = static_cast<size_t>(clean.peak_bytes * MEMORY_FACTOR) + MEMORY_ALLOWANCE;
+    printf("%s: %zu B, %zu elements, %zu slots, %.0f us (%.1f ns/B), peak heap %zu B\n", payload.file,
+           compact.size(), clean.result.elements, clean.result.slots, clean.ns / 1000, ns_per_byte,
+           clean.peak_bytes);
+
+    for (size_t i = 0; i < cases; ++i) {
+      const std::string &source = (i % 4 == 3) ? pretty : compact;
+      std::string body = source;
+      const Mutation mutation = mutator.pick();
+      if (!mutator.apply(mutation, body))
+        continue;
+      if (!dump_dir.empty()) {
+        char name[64];
+        snprintf(name, sizeof(name), "/%s-%zu-%s", payload.mode == Mode::SEVEN_DAYS ? "7d" : "3d", i,
+                 cwa_test::mutation_name(mutation));
+        std::ofstream out(dump_dir + name, std::ios::binary);
+        out.put(payload.mode == Mode::SEVEN_DAYS ? '7' : '3');
+        out.write(body.data(), body.size());
+      }
+
+      Measurement m = measure(harness, body, payload.mode);
+      const double time_limit = TIME_FACTOR * ns_per_byte * body.size() + TIME_ALLOWANCE_NS;
+      if (m.ns > time_limit)
+        m = measure_best(harness, body, payload.mode, 3);
+
+      KindStats &kind = stats[static_cast<size_t>(mutation)];
+      ++kind.cases;
+      kind.parsed += m.result.ok;
+      kind.worst_ns_per_byte = std::max(kind.worst_ns_per_byte, m.ns / std::max<size_t>(body.size(), 1));
+      kind.worst_peak = std::max(kind.worst_peak, m.peak_bytes);
+
+      const char *problem = nullptr;
+      if (m.ns > time_limit) {
+        problem = "too slow";
+      } else if (m.peak_bytes > peak_limit) {
+        problem = "too much memory";
+      } else if (mutation == Mutation::TRUNCATE && m.result.ok &&
+                 body.find_last_not_of(" \r\n\t") < source.find_last_not_of(" \r\n\t")) {
+        // Only trailing whitespace may be cut from an accepted response
+        problem = "truncated response accepted";
+      }
+      if (problem != nullptr) {
+        printf("FAIL %s case %zu (%s, %zu B): %s: %.0f us (limit %.0f), peak %zu B (limit %zu)\n", payload.file, i,
+               cwa_test::mutation_name(mutation), body.size(), problem, m.ns / 1000, time_limit / 1000,
+               m.peak_bytes, peak_limit);
+        ++failures;
+      }
+    }
+  }
+
+  for (size_t k = 0; k < static_cast<size_t>(Mutation::COUNT); ++k) {
+    const KindStats &kind = stats[k];
+    printf("%-12s %4zu cases, %4zu parsed, worst %.1f ns/B, worst peak heap %zu B\n",
+           cwa_test::mutation_name(static_cast<Mutation>(k)), kind.cases, kind.parsed, kind.worst_ns_per_byte,
+           kind.worst_peak);
+  }
+  printf(failures == 0 ? "PASS\n" : "%d FAILURES\n", failures);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,302 @@
+// HttpStreamAdapter against FakeContainer: find() (Boyer-Moore-Horspool and
+// the findUntil() fallback for long patterns), findUntil() with overlapping
+// patterns, the buffer rewind, truncation on stalls and errors, and a sweep of
+// full parses over chunk-size distributions that must match the BufferContainer
+// baseline.
+//
+// Usage: stream_adapter_test [--resources DIR] [--seed S]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "fake_container.h"
+#include "parse_harness.h"
+
+using cwa_test::Chunking;
+using cwa_test::FakeContainer;
+using cwa_test::HttpStreamAdapter;
+using cwa_test::Mode;
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond, ...) \
+  do { \
+    if (!(cond)) { \
+      printf("FAIL %s:%d: %s: ", __FILE__, __LINE__, #cond); \
+      printf(__VA_ARGS__); \
+      printf("\n"); \
+      ++failures; \
+    } \
+  } while (0)
+
+std::string random_text(std::mt19937 &rng, size_t size, const char *alphabet) {
+  const size_t n = strlen(alphabet);
+  std::string out(size, ' ');
+  for (char &c : out)
+    c = alphabet[rng() % n];
+  return out;
+}
+
+Chunking random_chunking(std::mt19937 &rng) {
+  Chunking chunking;
+  chunking.min_chunk = 1 + rng() % 8;
+  chunking.max_chunk = chunking.min_chunk + rng() % 200;
+  chunking.retry_chance = (rng() % 4 == 0) ? 0.3 : 0;
+  chunking.max_retries = 50;
+  return chunking;
+}
+
+// Where find(target) leaves the stream after consuming from pos, or npos
+size_t expected_find(const std::string &body, size_t pos, const std::string &target) {
+  const size_t at = body.find(target, pos);
+  return at == std::string::npos ? std::string::npos : at + target.size();
+}
+
+// Where findUntil(target, terminator) leaves the stream, and whether it found target
+std::pair<size_t, bool> expected_find_until(const std::string &body, size_t pos, const std::string &target,
+                                            const std::string &terminator) {
+  const size_t target_end = expected_find(body, pos, target);
+  const size_t term_end = expected_find(body, pos, terminator);
+  if (target_end != std::string::npos && (term_end == std::string::npos || target_end <= term_end))
+    return {target_end, true};
+  if (term_end != std::string::npos)
+    return {term_end, false};
+  return {body.size(), false};
+}
+
+// Repeated find() over random bodies, chunkings and buffer sizes; patterns up
+// to 40 bytes cover both the BMH path and the fallback past buf_size / 2
+void test_find(uint32_t seed) {
+  std::mt19937 rng(seed);
+  for (int round = 0; round < 2000; ++round) {
+    const char *alphabet = round % 2 ? "ab" : "ab\"{:";
+    const std::string body = random_text(rng, 1 + rng() % 3000, alphabet);
+    const size_t buffer_size = 64 << (rng() % 4);
+    auto container = std::make_shared<FakeContainer>(body, random_chunking(rng), rng());
+    HttpStreamAdapter stream(container, buffer_size);
+
+    size_t pos = 0;
+    for (int i = 0; i < 20 && pos < body.size(); ++i) {
+      std::string target = random_text(rng, 1 + rng() % 40, alphabet);
+      // Mostly search for something that is there
+      if (rng() % 4 != 0) {
+        const size_t at = pos + rng() % (body.size() - pos);
+        target = body.substr(at, target.size());
+      }
+      const size_t expected = expected_find(body, pos, target);
+      const bool found = stream.find(target.c_str());
+      CHECK(found == (expected != std::string::npos), "round %d: find(\"%s\") from %zu in %zu B, buffer %zu", round,
+            target.c_str(), pos, body.size(), buffer_size);
+      pos = found ? expected : body.size();
+      CHECK(stream.getBytesRead() == pos, "round %d: find(\"%s\") consumed %zu, expected %zu", round, target.c_str(),
+            stream.getBytesRead(), pos);
+      if (stream.getBytesRead() != pos)
+        break;
+      const int next = stream.peek();
+      CHECK(next == (pos < body.size() ? static_cast<uint8_t>(body[pos]) : -1), "round %d: byte after find", round);
+    }
+  }
+}
+
+void test_find_until(uint32_t seed) {
+  // Patterns that overlap themselves, where a naive matcher restarts too late
+  const struct {
+    const char *body, *target, *terminator;
+    bool found;
+    size_t consumed;
+  } CASES[] = {
+      {"aaab", "aab", nullptr, true, 4},       {"aaaab]", "aab", "]", true, 5},
+      {"abababc", "ababc", nullptr, true, 7},  {"xx]aab", "aab", "]", false, 3},
+      {"\"a\",\"b\"]", ",", "]", true, 4},     {"aabaab", "abaab", "aab", false, 3},
+  };
+  for (const auto &c : CASES) {
+    auto container = std::make_shared<FakeContainer>(c.body, Chunking{1, 1}, 1);
+    HttpStreamAdapter stream(container, HttpStreamAdapter::MIN_BUFFER_SIZE);
+    const bool found = stream.findUntil(c.target, c.terminator);
+    CHECK(found == c.found && stream.getBytesRead() == c.consumed, "findUntil(\"%s\") in \"%s\": %d after %zu B",
+          c.target, c.body, found, stream.getBytesRead());
+  }
+
+  std::mt19937 rng(seed);
+  for (int round = 0; round < 2000; ++round) {
+    const std::string body = random_text(rng, 1 + rng() % 500, "ab]");
+    auto container = std::make_shared<FakeContainer>(body, random_chunking(rng), rng());
+    HttpStreamAdapter stream(container, HttpStreamAdapter::MIN_BUFFER_SIZE);
+    size_t pos = 0;
+    while (pos < body.size()) {
+      const std::string target = random_text(rng, 1 + rng() % 6, "ab");
+      const std::string terminator = random_text(rng, 1 + rng() % 2, "ab]");
+      const auto expected = expected_find_until(body, pos, target, terminator);
+      const bool found = stream.findUntil(target.c_str(), terminator.c_str());
+      CHECK(found == expected.second && stream.getBytesRead() == expected.first,
+            "round %d: findUntil(\"%s\", \"%s\") from %zu: %d after %zu, expected %d after %zu", round, target.c_str(),
+            terminator.c_str(), pos, found, stream.getBytesRead(), expected.second, expected.first);
+      if (stream.getBytesRead() != expected.first)
+        break;
+      pos = expected.first;
+    }
+  }
+}
+
+// Mixed read(), peek(), readBytes() and find() return the body unchanged, and
+// the rewind offers every container read the whole buffer
+void test_rewind(uint32_t seed) {
+  std::mt19937 rng(seed);
+  for (int round = 0; round < 500; ++round) {
+    const std::string body = random_text(rng, 1 + rng() % 20000, "abcdefgh");
+    const size_t buffer_size = 64 << (rng() % 7);
+    auto container = std::make_shared<FakeContainer>(body, random_chunking(rng), rng());
+    HttpStreamAdapter stream(container, buffer_size);
+    std::string out;
+    char chunk[512];
+    while (true) {
+      const int op = rng() % 4;
+      if (op == 0) {
+        const int c = stream.read();
+        if (c == -1)
+          break;
+        out += static_cast<char>(c);
+      } else if (op == 1) {
+        stream.peek();
+      } else if (op == 2) {
+        const size_t n = stream.readBytes(chunk, rng() % sizeof(chunk));
+        out.append(chunk, n);
+        if (n == 0 && stream.peek() == -1)
+          break;
+      } else {
+        // A one-byte find() consumes exactly up to its match
+        const char target[2] = {static_cast<char>('a' + rng() % 8), '\0'};
+        const size_t before = stream.getBytesRead();
+        if (!stream.find(target)) {
+          out.append(body, before, std::string::npos);
+          break;
+        }
+        out.append(body, before, stream.getBytesRead() - before);
+      }
+    }
+    CHECK(out == body, "round %d: read back %zu of %zu B", round, out.size(), body.size());
+    CHECK(!stream.isTruncated(), "round %d: truncated", round);
+    // Every op drains the buffer before it refills, so the rewind must offer all of it
+    CHECK(container->min_offered() == buffer_size, "round %d: a read was offered %zu B of a %zu B buffer", round,
+          container->min_offered(), buffer_size);
+  }
+
+  // Chunks at least as large as the buffer: every read fills what is free
+  const std::string body(64 * 1024, 'x');
+  auto container = std::make_shared<FakeContainer>(body, Chunking{8192, 8192}, 1);
+  HttpStreamAdapter stream(container, 1024);
+  while (stream.read() != -1) {
+  }
+  CHECK(container->data_reads() == body.size() / 1024, "%zu data reads for %zu B through 1 KB", container->data_reads(),
+        body.size());
+}
+
+void test_truncation() {
+  const std::string body(10000, 'x');
+  struct Case {
+    const char *name;
+    Chunking chunking;
+    bool truncated;
+  } CASES[] = {
+      {"retry storms", {1, 100, 0.5, 2000}, false},
+      {"stall within the timeout", {1, 100, 0, 0, 5000, 9000}, false},
+      {"stall past the timeout", {1, 100, 0, 0, 5000, 11000}, true},
+      {"read error", {1, 100, 0, 0, SIZE_MAX, 0, 5000}, true},
+  };
+  for (const Case &c : CASES) {
+    auto container = std::make_shared<FakeContainer>(body, c.chunking, 1);
+    HttpStreamAdapter stream(container, 1024, 10000);
+    size_t n = 0;
+    while (stream.read() != -1)
+      ++n;
+    CHECK(stream.isTruncated() == c.truncated, "%s: isTruncated() %d", c.name, stream.isTruncated());
+    CHECK(n == (c.truncated ? 5000 : body.size()), "%s: read %zu B", c.name, n);
+  }
+}
+
+struct Distribution {
+  const char *name;
+  Chunking chunking;
+};
+
+// Full parses through each chunking must equal the one-read baseline
+void test_parse_sweep(const std::string &resources, uint32_t seed) {
+  const struct {
+    const char *file;
+    Mode mode;
+  } PAYLOADS[] = {
+      {"town_forecast_api_3d_full.json", Mode::THREE_DAYS},
+      {"town_forecast_api_7d_full.json", Mode::SEVEN_DAYS},
+  };
+  const Distribution DISTRIBUTIONS[] = {
+      {"1 B", {1, 1}},
+      {"1-64 B", {1, 64}},
+      {"MTU-like", {536, 1460}},
+      {"large", {4096, 16384}},
+      {"1-1460 B + retries", {1, 1460, 0.2, 100}},
+  };
+  const size_t BUFFER_SIZES[] = {HttpStreamAdapter::MIN_BUFFER_SIZE, 256, HttpStreamAdapter::DEFAULT_BUFFER_SIZE,
+                                 HttpStreamAdapter::MAX_BUFFER_SIZE};
+
+  cwa_test::ParseHarness harness;
+  for (const auto &payload : PAYLOADS) {
+    const std::string body = cwa_test::compact_json(cwa_test::read_file(resources + "/" + payload.file));
+    const auto *data = reinterpret_cast<const uint8_t *>(body.data());
+    const cwa_test::ParseResult baseline = harness.parse(data, body.size(), payload.mode);
+    CHECK(baseline.ok && baseline.slots > 0, "%s: baseline parse", payload.file);
+    printf("%s: %zu B, %zu slots\n", payload.file, body.size(), baseline.slots);
+
+    for (const Distribution &distribution : DISTRIBUTIONS) {
+      for (size_t buffer_size : BUFFER_SIZES) {
+        auto container = std::make_shared<FakeContainer>(body, distribution.chunking, seed);
+        const auto start = std::chrono::steady_clock::now();
+        const cwa_test::ParseResult result =
+            harness.parse(data, body.size(), payload.mode, container, buffer_size);
+        const double us =
+            std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        CHECK(result.ok && result.slots == baseline.slots && result.hash_code == baseline.hash_code,
+              "%s, %s chunks, %zu B buffer: ok=%d slots=%zu", payload.file, distribution.name, buffer_size, result.ok,
+              result.slots);
+        printf("  %-20s buffer %4zu: %6zu reads (%6zu with data), %6.1f MB/s\n", distribution.name, buffer_size,
+               container->reads(), container->data_reads(), body.size() / us);
+      }
+    }
+
+    // Cut off by a stall anywhere, including within the closing brackets
+    for (size_t stall_at : {body.size() / 2, body.size() - 1}) {
+      auto container = std::make_shared<FakeContainer>(body, Chunking{1, 1460, 0, 0, stall_at, 20000}, seed);
+      const cwa_test::ParseResult result = harness.parse(data, body.size(), payload.mode, container);
+      CHECK(!result.ok, "%s: parsed although stalled at %zu of %zu B", payload.file, stall_at, body.size());
+    }
+  }
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  std::string resources = CWA_RESOURCES_DIR;
+  uint32_t seed = 1;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (strcmp(argv[i], "--resources") == 0) {
+      resources = argv[i + 1];
+    } else if (strcmp(argv[i], "--seed") == 0) {
+      seed = strtoul(argv[i + 1], nullptr, 10);
+    }
+  }
+
+  test_find(seed);
+  test_find_until(seed);
+  test_rewind(seed);
+  test_truncation();
+  test_parse_sweep(resources, seed);
+  printf(failures == 0 ? "PASS\n" : "%d FAILURES\n", failures);
+  return failures == 0 ? 0 : 1;
+}
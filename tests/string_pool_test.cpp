@@ -0,0 +1,133 @@
+// BasicStringPool with 16-bit offsets (linear lookup) and 32-bit offsets
+// (hash index): both must intern identically, through clear(), assign(),
+// compacted() and a limit, and the indexed pool must fill in linear time.
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "string_pool.h"
+
+using esphome::cwa_town_forecast::BasicStringPool;
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond, ...) \
+  do { \
+    if (!(cond)) { \
+      printf("FAIL %s:%d: %s: ", __FILE__, __LINE__, #cond); \
+      printf(__VA_ARGS__); \
+      printf("\n"); \
+      ++failures; \
+    } \
+  } while (0)
+
+std::vector<std::string> random_values(std::mt19937 &rng, size_t count, size_t unique) {
+  std::vector<std::string> values;
+  for (size_t i = 0; i < count; ++i)
+    values.push_back(std::to_string(rng() % unique) + std::string(rng() % 4, 'x'));
+  return values;
+}
+
+template<typename Pool> std::vector<size_t> intern_all(Pool &pool, const std::vector<std::string> &values) {
+  std::vector<size_t> offsets;
+  for (const auto &value : values)
+    offsets.push_back(pool.intern(value.c_str()));
+  return offsets;
+}
+
+// Every value reads back, and interning it again finds the same offset
+template<typename Pool>
+void check_readback(const char *what, Pool &pool, const std::vector<std::string> &values,
+                    const std::vector<size_t> &offsets) {
+  const size_t size = pool.size();
+  for (size_t i = 0; i < values.size(); ++i) {
+    CHECK(values[i] == pool.get(offsets[i]), "%s: value %zu reads \"%s\"", what, i, pool.get(offsets[i]));
+    CHECK(pool.intern(values[i].c_str()) == offsets[i], "%s: value %zu interned again", what, i);
+  }
+  CHECK(pool.size() == size, "%s: pool grew on re-interning", what);
+}
+
+void test_equivalence(uint32_t seed) {
+  std::mt19937 rng(seed);
+  BasicStringPool<uint16_t> linear;
+  BasicStringPool<uint32_t> indexed;
+  for (int round = 0; round < 3; ++round) {
+    const auto values = random_values(rng, 2000, 300);
+    const auto linear_offsets = intern_all(linear, values);
+    const auto indexed_offsets = intern_all(indexed, values);
+    CHECK(linear_offsets == indexed_offsets, "round %d: offsets differ", round);
+    check_readback("indexed", indexed, values, indexed_offsets);
+
+    // Keep every other value; the compacted pool indexes what it holds
+    std::vector<uint32_t> live;
+    for (size_t i = 0; i < indexed_offsets.size(); i += 2)
+      live.push_back(indexed_offsets[i]);
+    auto compacted = indexed.compacted([&](auto fn) {
+      for (uint32_t &off : live)
+        fn(off);
+    });
+    std::vector<std::string> kept;
+    std::vector<size_t> kept_offsets;
+    for (size_t i = 0; i < values.size(); i += 2) {
+      kept.push_back(values[i]);
+      kept_offsets.push_back(live[i / 2]);
+    }
+    check_readback("compacted", compacted, kept, kept_offsets);
+
+    // A pool assigned from serialized bytes finds its strings too
+    BasicStringPool<uint32_t> assigned;
+    const std::string bytes(indexed.data(), indexed.size());
+    CHECK(assigned.assign(bytes.size(),
+                          [&](char *dst, size_t n) {
+                            bytes.copy(dst, n);
+                            return true;
+                          }),
+          "assign");
+    check_readback("assigned", assigned, values, indexed_offsets);
+
+    linear.clear();
+    indexed.clear();
+    CHECK(indexed.intern(values[0].c_str()) == 1, "round %d: clear() left stale index entries", round);
+    indexed.clear();
+  }
+
+  // A limit drops new values but still finds old ones
+  BasicStringPool<uint32_t> limited;
+  limited.set_limit(16);
+  const uint32_t first = limited.intern("abcdef");
+  CHECK(limited.intern("0123456789") == 0 && limited.dropped_values() == 1, "limit not applied");
+  CHECK(limited.intern("abcdef") == first, "existing value refused at the limit");
+}
+
+// Doubling the unique values must not quadruple the fill time
+void test_scaling() {
+  double ns_per_value[2];
+  const size_t COUNTS[] = {20000, 40000};
+  for (int i = 0; i < 2; ++i) {
+    BasicStringPool<uint32_t> pool;
+    std::vector<std::string> values;
+    for (size_t n = 0; n < COUNTS[i]; ++n)
+      values.push_back("value-" + std::to_string(n * 7919));
+    const auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < 2; ++pass)
+      intern_all(pool, values);
+    ns_per_value[i] =
+        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / COUNTS[i];
+  }
+  printf("32-bit pool: %.0f ns/value at 20k values, %.0f ns/value at 40k\n", ns_per_value[0], ns_per_value[1]);
+  CHECK(ns_per_value[1] < ns_per_value[0] * 1.6 + 200, "interning cost grows with the pool");
+}
+
+}  // namespace
+
+int main() {
+  test_equivalence(1);
+  test_scaling();
+  printf(failures == 0 ? "PASS\n" : "%d FAILURES\n", failures);
+  return failures == 0 ? 0 : 1;
+}
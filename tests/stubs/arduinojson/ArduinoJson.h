@@ -0,0 +1,390 @@
+#pragma once
+
+// Host stand-in for ArduinoJson 7: a small DOM parser covering the subset of
+// the API the component uses, so the tests build without fetching the
+// library. Configure with CWA_ARDUINOJSON_DIR to test against the real one.
+//
+// Differences from the real library: filters are accepted but not applied,
+// and \uXXXX escapes decode to '?'.
+
+#include <cctype>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ArduinoJson {
+
+struct Allocator {
+  virtual void *allocate(size_t size) = 0;
+  virtual void deallocate(void *ptr) = 0;
+  virtual void *reallocate(void *ptr, size_t new_size) = 0;
+};
+
+struct Node {
+  enum Type { NUL, STR, NUM, BOOL, OBJ, ARR } type{NUL};
+  std::string text;  // string contents, or the literal of a number/boolean
+  std::vector<std::pair<std::string, Node *>> members;
+  std::vector<Node *> elements;
+};
+
+class JsonVariant;
+
+class JsonString {
+ public:
+  JsonString(const char *str = "") : str_(str) {}
+  const char *c_str() const { return this->str_; }
+  size_t size() const { return strlen(this->str_); }
+
+ private:
+  const char *str_;
+};
+
+class JsonPair {
+ public:
+  explicit JsonPair(const std::pair<std::string, Node *> *member) : member_(member) {}
+  JsonString key() const { return JsonString(this->member_->first.c_str()); }
+  JsonVariant value() const;
+
+ private:
+  const std::pair<std::string, Node *> *member_;
+};
+
+class JsonObject {
+ public:
+  JsonObject(Node *node = nullptr) : node_(node) {}
+
+  struct iterator {
+    const std::pair<std::string, Node *> *member;
+    JsonPair operator*() const { return JsonPair(this->member); }
+    iterator &operator++() {
+      ++this->member;
+      return *this;
+    }
+    bool operator!=(const iterator &other) const { return this->member != other.member; }
+  };
+  iterator begin() const { return {this->is_object_() ? this->node_->members.data() : nullptr}; }
+  iterator end() const {
+    return {this->is_object_() ? this->node_->members.data() + this->node_->members.size() : nullptr};
+  }
+
+ private:
+  bool is_object_() const { return this->node_ != nullptr && this->node_->type == Node::OBJ; }
+  Node *node_;
+};
+
+class JsonArray {
+ public:
+  JsonArray(Node *node = nullptr) : node_(node) {}
+
+  struct iterator {
+    Node *const *element;
+    JsonObject operator*() const { return JsonObject(*this->element); }
+    iterator &operator++() {
+      ++this->element;
+      return *this;
+    }
+    bool operator!=(const iterator &other) const { return this->element != other.element; }
+  };
+  iterator begin() const { return {this->is_array_() ? this->node_->elements.data() : nullptr}; }
+  iterator end() const {
+    return {this->is_array_() ? this->node_->elements.data() + this->node_->elements.size() : nullptr};
+  }
+  size_t size() const { return this->is_array_() ? this->node_->elements.size() : 0; }
+
+ private:
+  bool is_array_() const { return this->node_ != nullptr && this->node_->type == Node::ARR; }
+  Node *node_;
+};
+
+namespace detail {
+template<typename T> struct Converter;
+}  // namespace detail
+
+class JsonVariant {
+ public:
+  JsonVariant(Node *node = nullptr) : node_(node) {}
+
+  template<typename T> bool is() const;
+  template<typename T> T as() const { return detail::Converter<T>::from(this->node_); }
+
+  JsonVariant operator[](const char *key) const {
+    if (this->node_ != nullptr && this->node_->type == Node::OBJ) {
+      for (auto &member : this->node_->members) {
+        if (member.first == key)
+          return JsonVariant(member.second);
+      }
+    }
+    return {};
+  }
+  JsonVariant operator[](size_t index) const {
+    if (this->node_ != nullptr && this->node_->type == Node::ARR && index < this->node_->elements.size())
+      return JsonVariant(this->node_->elements[index]);
+    return {};
+  }
+  bool isNull() const { return this->node_ == nullptr || this->node_->type == Node::NUL; }
+  // Only used to build filters, which are not applied
+  JsonVariant &operator=(bool) { return *this; }
+
+ private:
+  Node *node_;
+};
+
+template<> inline bool JsonVariant::is<const char *>() const {
+  return this->node_ != nullptr && this->node_->type == Node::STR;
+}
+
+inline JsonVariant JsonPair::value() const { return JsonVariant(this->member_->second); }
+
+namespace detail {
+template<> struct Converter<const char *> {
+  static const char *from(Node *node) { return node != nullptr && node->type == Node::STR ? node->text.c_str() : nullptr; }
+};
+template<> struct Converter<std::string> {
+  static std::string from(Node *node) {
+    if (node == nullptr || node->type == Node::OBJ || node->type == Node::ARR || node->type == Node::NUL)
+      return std::string();
+    return node->text;
+  }
+};
+template<> struct Converter<JsonArray> {
+  static JsonArray from(Node *node) { return JsonArray(node); }
+};
+template<> struct Converter<JsonObject> {
+  static JsonObject from(Node *node) { return JsonObject(node); }
+};
+}  // namespace detail
+
+class JsonDocument {
+ public:
+  JsonDocument(Allocator *allocator = nullptr) {}
+
+  void clear() {
+    this->nodes_.clear();
+    this->root_ = nullptr;
+  }
+  JsonVariant operator[](const char *key) const { return JsonVariant(this->root_)[key]; }
+  template<typename T> T as() const { return detail::Converter<T>::from(this->root_); }
+
+  Node *make_node() {
+    this->nodes_.emplace_back(new Node());
+    return this->nodes_.back().get();
+  }
+  void set_root(Node *root) { this->root_ = root; }
+
+ private:
+  std::vector<std::unique_ptr<Node>> nodes_;
+  Node *root_{nullptr};
+};
+
+class DeserializationError {
+ public:
+  enum Code { Ok, EmptyInput, IncompleteInput, InvalidInput, NoMemory, TooDeep };
+
+  DeserializationError(Code code = Ok) : code_(code) {}
+  explicit operator bool() const { return this->code_ != Ok; }
+  bool operator==(Code code) const { return this->code_ == code; }
+  bool operator!=(Code code) const { return this->code_ != code; }
+  Code code() const { return this->code_; }
+  const char *c_str() const {
+    static const char *const NAMES[] = {"Ok", "EmptyInput", "IncompleteInput", "InvalidInput", "NoMemory", "TooDeep"};
+    return NAMES[this->code_];
+  }
+
+ private:
+  Code code_;
+};
+
+namespace DeserializationOption {
+class Filter {
+ public:
+  Filter(JsonDocument &filter) {}
+};
+class NestingLimit {
+ public:
+  NestingLimit(int limit) : limit(limit) {}
+  int limit;
+};
+}  // namespace DeserializationOption
+
+namespace detail {
+
+// Reads one value from a stream with read()/peek(), as deserializeJson() does
+template<typename TStream> class Parser {
+ public:
+  Parser(TStream &stream, JsonDocument &doc, int nesting_limit)
+      : stream_(stream), doc_(doc), nesting_limit_(nesting_limit) {}
+
+  DeserializationError::Code parse_value(Node *&out, int depth) {
+    if (depth > this->nesting_limit_)
+      return DeserializationError::TooDeep;
+    int c = this->skip_whitespace_();
+    if (c < 0)
+      return depth == 0 ? DeserializationError::EmptyInput : DeserializationError::IncompleteInput;
+    out = this->doc_.make_node();
+    if (c == '"') {
+      this->stream_.read();
+      out->type = Node::STR;
+      return this->parse_string_(out->text);
+    }
+    if (c == '{')
+      return this->parse_object_(out, depth);
+    if (c == '[')
+      return this->parse_array_(out, depth);
+    return this->parse_literal_(out);
+  }
+
+ private:
+  int skip_whitespace_() {
+    int c;
+    while ((c = this->stream_.peek()) == ' ' || c == '\n' || c == '\r' || c == '\t')
+      this->stream_.read();
+    return c;
+  }
+
+  DeserializationError::Code parse_string_(std::string &out) {
+    while (true) {
+      int c = this->stream_.read();
+      if (c < 0)
+        return DeserializationError::IncompleteInput;
+      if (c == '"')
+        return DeserializationError::Ok;
+      if (c == '\\') {
+        c = this->stream_.read();
+        if (c < 0)
+          return DeserializationError::IncompleteInput;
+        if (c == 'n') {
+          c = '\n';
+        } else if (c == 't') {
+          c = '\t';
+        } else if (c == 'u') {
+          for (int i = 0; i < 4; ++i) {
+            if (this->stream_.read() < 0)
+              return DeserializationError::IncompleteInput;
+          }
+          c = '?';
+        }
+      }
+      out += static_cast<char>(c);
+    }
+  }
+
+  DeserializationError::Code parse_object_(Node *out, int depth) {
+    this->stream_.read();
+    out->type = Node::OBJ;
+    if (this->skip_whitespace_() == '}') {
+      this->stream_.read();
+      return DeserializationError::Ok;
+    }
+    while (true) {
+      int c = this->skip_whitespace_();
+      if (c < 0)
+        return DeserializationError::IncompleteInput;
+      if (c != '"')
+        return DeserializationError::InvalidInput;
+      this->stream_.read();
+      std::string key;
+      auto err = this->parse_string_(key);
+      if (err != DeserializationError::Ok)
+        return err;
+      c = this->skip_whitespace_();
+      if (c < 0)
+        return DeserializationError::IncompleteInput;
+      if (c != ':')
+        return DeserializationError::InvalidInput;
+      this->stream_.read();
+      Node *value;
+      err = this->parse_value(value, depth + 1);
+      if (err != DeserializationError::Ok)
+        return err;
+      out->members.emplace_back(std::move(key), value);
+      if ((err = this->parse_separator_('}')) != DeserializationError::Ok)
+        return err == DeserializationError::EmptyInput ? DeserializationError::Ok : err;
+    }
+  }
+
+  DeserializationError::Code parse_array_(Node *out, int depth) {
+    this->stream_.read();
+    out->type = Node::ARR;
+    if (this->skip_whitespace_() == ']') {
+      this->stream_.read();
+      return DeserializationError::Ok;
+    }
+    while (true) {
+      Node *value;
+      auto err = this->parse_value(value, depth + 1);
+      if (err != DeserializationError::Ok)
+        return err;
+      out->elements.push_back(value);
+      if ((err = this->parse_separator_(']')) != DeserializationError::Ok)
+        return err == DeserializationError::EmptyInput ? DeserializationError::Ok : err;
+    }
+  }
+
+  // Ok after a ',', EmptyInput (used as "done") after the closing bracket
+  DeserializationError::Code parse_separator_(char close) {
+    int c = this->skip_whitespace_();
+    if (c < 0)
+      return DeserializationError::IncompleteInput;
+    this->stream_.read();
+    if (c == close)
+      return DeserializationError::EmptyInput;
+    return c == ',' ? DeserializationError::Ok : DeserializationError::InvalidInput;
+  }
+
+  DeserializationError::Code parse_literal_(Node *out) {
+    std::string token;
+    int c;
+    while ((c = this->stream_.peek()) >= 0 && (isalnum(c) || c == '-' || c == '+' || c == '.')) {
+      token += static_cast<char>(c);
+      this->stream_.read();
+    }
+    if (token.empty())
+      return c < 0 ? DeserializationError::IncompleteInput : DeserializationError::InvalidInput;
+    if (token == "null") {
+      out->type = Node::NUL;
+    } else if (token == "true" || token == "false") {
+      out->type = Node::BOOL;
+    } else {
+      char *end;
+      strtod(token.c_str(), &end);
+      if (*end != '\0')
+        return DeserializationError::InvalidInput;
+      out->type = Node::NUM;
+    }
+    out->text = std::move(token);
+    return DeserializationError::Ok;
+  }
+
+  TStream &stream_;
+  JsonDocument &doc_;
+  int nesting_limit_;
+};
+
+inline int nesting_limit(int limit) { return limit; }
+template<typename... Options>
+int nesting_limit(int limit, DeserializationOption::NestingLimit option, Options... options) {
+  return nesting_limit(option.limit, options...);
+}
+template<typename Option, typename... Options> int nesting_limit(int limit, Option, Options... options) {
+  return nesting_limit(limit, options...);
+}
+
+}  // namespace detail
+
+template<typename TStream, typename... Options>
+DeserializationError deserializeJson(JsonDocument &doc, TStream &stream, Options... options) {
+  doc.clear();
+  detail::Parser<TStream> parser(stream, doc, detail::nesting_limit(10, options...));
+  Node *root = nullptr;
+  auto err = parser.parse_value(root, 0);
+  doc.set_root(root);
+  return err;
+}
+
+}  // namespace ArduinoJson
+
+using namespace ArduinoJson;
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+#include "esp_memory_utils.h"
+#include "esphome/core/application.h"
+
+// No PSRAM on host: everything comes from the system heap, and the heap
+// statistics read as zero.
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_SPIRAM (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_DEFAULT (1 << 12)
+
+inline void *heap_caps_malloc(size_t size, uint32_t caps) { return esphome::host_malloc(size); }
+inline void *heap_caps_realloc(void *ptr, size_t size, uint32_t caps) { return esphome::host_realloc(ptr, size); }
+inline void heap_caps_free(void *ptr) { esphome::host_free(ptr); }
+inline size_t heap_caps_get_total_size(uint32_t caps) { return 0; }
+inline size_t heap_caps_get_free_size(uint32_t caps) { return 0; }
+inline size_t heap_caps_get_largest_free_block(uint32_t caps) { return 0; }
+inline size_t heap_caps_get_minimum_free_size(uint32_t caps) { return 0; }
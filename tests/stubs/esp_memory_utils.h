@@ -0,0 +1,3 @@
+#pragma once
+
+inline bool esp_ptr_external_ram(const void *ptr) { return false; }
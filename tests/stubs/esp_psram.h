@@ -0,0 +1,3 @@
+#pragma once
+
+inline bool esp_psram_is_initialized() { return false; }
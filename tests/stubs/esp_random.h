@@ -0,0 +1,5 @@
+#pragma once
+
+#include <cstdint>
+
+inline uint32_t esp_random() { return 0; }
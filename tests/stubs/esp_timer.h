@@ -0,0 +1,5 @@
+#pragma once
+
+#include <cstdint>
+
+inline int64_t esp_timer_get_time() { return 0; }
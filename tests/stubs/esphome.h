@@ -0,0 +1,9 @@
+#pragma once
+
+#include "esphome/core/application.h"
+#include "esphome/core/automation.h"
+#include "esphome/core/component.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+#include "esphome/core/time.h"
+#include "ArduinoJson.h"
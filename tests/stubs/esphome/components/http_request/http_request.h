@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "esphome/core/application.h"
+#include "esphome/core/component.h"
+
+namespace esphome {
+namespace http_request {
+
+struct Header {
+  std::string name;
+  std::string value;
+};
+
+class HttpContainer {
+ public:
+  virtual ~HttpContainer() = default;
+  size_t content_length;
+  int status_code;
+  uint32_t duration_ms;
+
+  virtual int read(uint8_t *buf, size_t max_len) = 0;
+  virtual void end() = 0;
+
+  bool is_read_complete() const { return this->content_length > 0 && this->bytes_read_ >= this->content_length; }
+  size_t get_bytes_read() const { return this->bytes_read_; }
+  std::string get_response_header(const std::string &header_name) { return ""; }
+
+ protected:
+  size_t bytes_read_{0};
+};
+
+enum class HttpReadLoopResult : uint8_t { DATA, COMPLETE, RETRY, ERROR, TIMEOUT };
+
+// Mirrors ESPHome's helper: no data yet is a RETRY after a 1 ms delay until
+// timeout_ms have passed without data
+inline HttpReadLoopResult http_read_loop_result(int bytes_read, uint32_t &last_data_time, uint32_t timeout_ms,
+                                                bool is_read_complete) {
+  if (bytes_read > 0) {
+    last_data_time = millis();
+    return HttpReadLoopResult::DATA;
+  }
+  if (bytes_read < 0)
+    return HttpReadLoopResult::ERROR;
+  if (is_read_complete)
+    return HttpReadLoopResult::COMPLETE;
+  if (millis() - last_data_time >= timeout_ms)
+    return HttpReadLoopResult::TIMEOUT;
+  delay(1);
+  return HttpReadLoopResult::RETRY;
+}
+
+class HttpRequestComponent : public Component {
+ public:
+  std::shared_ptr<HttpContainer> get(const std::string &url) { return nullptr; }
+  std::shared_ptr<HttpContainer> get(const std::string &url, const std::list<Header> &request_headers) {
+    return nullptr;
+  }
+  std::shared_ptr<HttpContainer> get(const std::string &url, const std::list<Header> &request_headers,
+                                     const std::set<std::string> &collect_headers) {
+    return nullptr;
+  }
+  uint32_t get_timeout() const { return 0; }
+};
+
+}  // namespace http_request
+}  // namespace esphome
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace esphome {
+namespace sensor {
+
+class Sensor {
+ public:
+  void publish_state(float state) { this->state = state; }
+  float get_raw_state() const { return this->state; }
+  bool has_state() const { return true; }
+  std::string get_name() const { return ""; }
+  int8_t get_accuracy_decimals() { return 1; }
+  bool get_force_update() const { return false; }
+
+  float state{0};
+};
+
+}  // namespace sensor
+}  // namespace esphome
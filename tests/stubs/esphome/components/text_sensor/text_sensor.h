@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string>
+
+namespace esphome {
+namespace text_sensor {
+
+class TextSensor {
+ public:
+  void publish_state(const std::string &state) { this->state = state; }
+  const std::string &get_raw_state() const { return this->state; }
+  bool has_state() const { return true; }
+
+  std::string state;
+};
+
+}  // namespace text_sensor
+}  // namespace esphome
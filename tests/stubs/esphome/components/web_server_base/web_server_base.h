@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "esphome/core/component.h"
+
+// Arduino's String as far as request URLs go: it compares with const char *
+// and another String, but not with std::string
+class String {
+ public:
+  String(const char *str = "") : str_(str) {}
+  const char *c_str() const { return this->str_.c_str(); }
+  bool operator==(const char *other) const { return strcmp(this->str_.c_str(), other) == 0; }
+  bool operator==(const String &other) const { return this->str_ == other.str_; }
+
+ private:
+  std::string str_;
+};
+
+namespace esphome {
+namespace web_server_idf {
+
+enum http_method { HTTP_GET = 1, HTTP_POST = 3 };
+
+class AsyncWebServerResponse {
+ public:
+  virtual ~AsyncWebServerResponse() = default;
+};
+
+// Records what was sent instead of sending it
+class AsyncWebServerRequest {
+ public:
+  http_method method() const { return HTTP_GET; }
+  // ESPAsyncWebServer's signature, the stricter of the two servers
+  String url() const { return String(this->url_.c_str()); }
+  void send(AsyncWebServerResponse *response) { delete response; }
+  void send(int code, const char *content_type = nullptr, const char *content = nullptr) { this->code_ = code; }
+  AsyncWebServerResponse *beginResponse(int code, const char *content_type, const uint8_t *data,
+                                        const size_t data_size) {
+    this->code_ = code;
+    this->body_.assign(reinterpret_cast<const char *>(data), data_size);
+    return new AsyncWebServerResponse();
+  }
+
+  std::string url_;
+  int code_{0};
+  std::string body_;
+};
+
+class AsyncWebHandler {
+ public:
+  virtual ~AsyncWebHandler() = default;
+  virtual bool canHandle(AsyncWebServerRequest *request) const { return false; }
+  virtual void handleRequest(AsyncWebServerRequest *request) {}
+};
+
+}  // namespace web_server_idf
+
+using namespace web_server_idf;
+
+namespace web_server_base {
+class WebServerBase : public Component {
+ public:
+  void init() {}
+  void add_handler(AsyncWebHandler *handler) {}
+};
+}  // namespace web_server_base
+
+}  // namespace esphome
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+
+struct Application {
+  void feed_wdt() {}
+};
+extern Application App;
+
+inline void yield() {}
+
+// A virtual clock: millis() only advances through delay() and
+// host_advance_ms(), so timeouts run instantly and deterministically.
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void host_advance_ms(uint32_t ms);
+
+// Heap accounting for tests that bound memory: every operator new and every
+// allocation through the RAMAllocator and heap_caps stand-ins is counted.
+void *host_malloc(size_t size);
+void *host_realloc(void *ptr, size_t size);
+void host_free(void *ptr);
+size_t host_heap_live();
+size_t host_heap_peak();
+void host_heap_reset_peak();
+
+}  // namespace esphome
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <functional>
+
+namespace esphome {
+
+template<typename... Ts> class Trigger {
+ public:
+  void trigger(Ts... x) {}
+};
+
+template<typename T, typename... X> class TemplatableValue {
+ public:
+  TemplatableValue() = default;
+  template<typename V> TemplatableValue(V v) : value_(v), has_value_(true) {}
+  bool has_value() const { return this->has_value_; }
+  T value(X... x) const { return this->value_; }
+  T value_or(X... x, T default_value) const { return this->has_value_ ? this->value_ : default_value; }
+
+ private:
+  T value_{};
+  bool has_value_{false};
+};
+
+}  // namespace esphome
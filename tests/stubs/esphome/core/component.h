@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "esphome/core/application.h"
+
+namespace esphome {
+
+namespace setup_priority {
+static const float LATE = -100.0f;
+static const float AFTER_WIFI = 250.0f;
+}  // namespace setup_priority
+
+// The scheduler is not simulated: timeouts and intervals never fire.
+class Component {
+ public:
+  virtual void setup() {}
+  virtual void loop() {}
+  virtual void dump_config() {}
+  virtual float get_setup_priority() const { return 0; }
+  void set_timeout(const std::string &name, uint32_t timeout, std::function<void()> &&f) {}
+  void set_timeout(uint32_t timeout, std::function<void()> &&f) {}
+  bool cancel_timeout(const std::string &name) { return true; }
+  void set_interval(const std::string &name, uint32_t interval, std::function<void()> &&f) {}
+  bool cancel_interval(const std::string &name) { return true; }
+  void status_set_warning(const char *message = nullptr) {}
+  void status_clear_warning() {}
+  void defer(std::function<void()> &&f) {}
+};
+
+const uint32_t SCHEDULER_DONT_RUN = 4294967295UL;
+
+class PollingComponent : public Component {
+ public:
+  virtual void update() = 0;
+  uint32_t get_update_interval() const { return this->update_interval_; }
+  void set_update_interval(uint32_t update_interval) { this->update_interval_ = update_interval; }
+  void start_poller() {}
+  void stop_poller() {}
+
+ protected:
+  uint32_t update_interval_{SCHEDULER_DONT_RUN};
+};
+
+}  // namespace esphome
+
+#define LOG_UPDATE_INTERVAL(x)
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+#include "esphome/core/application.h"
+
+namespace esphome {
+
+template<class T> class RAMAllocator {
+ public:
+  using value_type = T;
+  enum Flags { NONE = 0, ALLOC_EXTERNAL = 1, ALLOC_INTERNAL = 2, ALLOW_FAILURE = 4 };
+
+  RAMAllocator() = default;
+  RAMAllocator(uint8_t flags) : flags_(flags) {}
+  template<class U> constexpr RAMAllocator(const RAMAllocator<U> &other) : flags_(other.flags_) {}
+
+  T *allocate(size_t n) { return static_cast<T *>(host_malloc(n * sizeof(T))); }
+  T *reallocate(T *p, size_t n) { return static_cast<T *>(host_realloc(p, n * sizeof(T))); }
+  void deallocate(T *p, size_t n) { host_free(p); }
+  size_t get_free_heap_size() const { return 0; }
+  size_t get_max_free_block_size() const { return 0; }
+
+  uint8_t flags_{0};
+};
+
+class Mutex {
+ public:
+  Mutex() = default;
+  Mutex(const Mutex &) = delete;
+  void lock() {}
+  void unlock() {}
+};
+
+class LockGuard {
+ public:
+  LockGuard(Mutex &mutex) : mutex_(mutex) { mutex.lock(); }
+  ~LockGuard() { this->mutex_.unlock(); }
+
+ private:
+  Mutex &mutex_;
+};
+
+inline uint32_t random_uint32() { return 0; }
+inline uint32_t fnv1_hash(const std::string &) { return 0; }
+
+}  // namespace esphome
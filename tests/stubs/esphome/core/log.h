@@ -0,0 +1,21 @@
+#pragma once
+
+// Host stand-in: log lines go to stderr when CWA_TEST_LOG is set in the
+// environment, and are dropped otherwise so fuzzing is not slowed down.
+
+#define ESP_LOG_VERBOSE 5
+#define ESP_LOG_LEVEL 5
+#define ESPHOME_LOG_LEVEL 5
+#define ESPHOME_LOG_LEVEL_VERBOSE 5
+
+namespace esphome {
+void host_log(const char *tag, const char *format, ...) __attribute__((format(printf, 2, 3)));
+}  // namespace esphome
+
+#define ESP_LOGE(tag, ...) ::esphome::host_log(tag, __VA_ARGS__)
+#define ESP_LOGW(tag, ...) ::esphome::host_log(tag, __VA_ARGS__)
+#define ESP_LOGI(tag, ...) ::esphome::host_log(tag, __VA_ARGS__)
+#define ESP_LOGD(tag, ...) ::esphome::host_log(tag, __VA_ARGS__)
+#define ESP_LOGV(tag, ...) ::esphome::host_log(tag, __VA_ARGS__)
+#define ESP_LOGVV(tag, ...) ::esphome::host_log(tag, __VA_ARGS__)
+#define ESP_LOGCONFIG(tag, ...) ::esphome::host_log(tag, __VA_ARGS__)
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+
+namespace esphome {
+
+struct ESPTime {
+  uint8_t second, minute, hour, day_of_week, day_of_month;
+  uint16_t day_of_year;
+  uint8_t month;
+  uint16_t year;
+  bool is_dst;
+  time_t timestamp;
+
+  std::string strftime(const std::string &format) const { return ""; }
+  bool is_valid() const { return true; }
+  std::tm to_c_tm() const { return std::tm{}; }
+  void recalc_timestamp_local() {}
+  void recalc_timestamp_utc(bool use_day_of_year = true) {}
+  int32_t timezone_offset() const { return 0; }
+  static ESPTime from_epoch_local(time_t epoch) { return ESPTime{}; }
+  static ESPTime from_c_tm(struct tm *c_tm, time_t epoch) { return ESPTime{}; }
+};
+
+}  // namespace esphome
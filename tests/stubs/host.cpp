@@ -0,0 +1,84 @@
+#include <malloc.h>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include "esphome/core/application.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+
+Application App;
+
+static uint32_t host_clock_ms = 0;
+
+uint32_t millis() { return host_clock_ms; }
+uint32_t micros() { return host_clock_ms * 1000; }
+void delay(uint32_t ms) { host_clock_ms += ms; }
+void host_advance_ms(uint32_t ms) { host_clock_ms += ms; }
+
+static size_t heap_live = 0;
+static size_t heap_peak = 0;
+
+void *host_malloc(size_t size) {
+  void *ptr = malloc(size);
+  if (ptr != nullptr) {
+    heap_live += malloc_usable_size(ptr);
+    if (heap_live > heap_peak)
+      heap_peak = heap_live;
+  }
+  return ptr;
+}
+
+void *host_realloc(void *ptr, size_t size) {
+  if (size == 0) {
+    host_free(ptr);
+    return nullptr;
+  }
+  const size_t old_size = ptr != nullptr ? malloc_usable_size(ptr) : 0;
+  void *out = realloc(ptr, size);
+  if (out == nullptr)
+    return nullptr;
+  heap_live += malloc_usable_size(out) - old_size;
+  if (heap_live > heap_peak)
+    heap_peak = heap_live;
+  return out;
+}
+
+void host_free(void *ptr) {
+  if (ptr == nullptr)
+    return;
+  heap_live -= malloc_usable_size(ptr);
+  free(ptr);
+}
+
+size_t host_heap_live() { return heap_live; }
+size_t host_heap_peak() { return heap_peak; }
+void host_heap_reset_peak() { heap_peak = heap_live; }
+
+void host_log(const char *tag, const char *format, ...) {
+  static const bool enabled = std::getenv("CWA_TEST_LOG") != nullptr;
+  if (!enabled)
+    return;
+  va_list args;
+  va_start(args, format);
+  fprintf(stderr, "[%s] ", tag);
+  vfprintf(stderr, format, args);
+  fputc('\n', stderr);
+  va_end(args);
+}
+
+}  // namespace esphome
+
+void *operator new(size_t size) {
+  void *ptr = esphome::host_malloc(size != 0 ? size : 1);
+  if (ptr == nullptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+void *operator new[](size_t size) { return ::operator new(size); }
+void operator delete(void *ptr) noexcept { esphome::host_free(ptr); }
+void operator delete[](void *ptr) noexcept { esphome::host_free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { esphome::host_free(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { esphome::host_free(ptr); }
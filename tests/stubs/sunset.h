@@ -0,0 +1,10 @@
+#pragma once
+
+// Fixed 06:00 sunrise and 18:00 sunset
+class SunSet {
+ public:
+  void setPosition(double lat, double lon, double tz) {}
+  void setCurrentDate(int y, int m, int d) {}
+  double calcSunrise() { return 360; }
+  double calcSunset() { return 1080; }
+};